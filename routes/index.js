@@ -3,49 +3,228 @@ const router = express.Router();
 const fs = require('fs');
 const child_process = require('child_process');
 const path = require('path');
+const crypto = require('crypto');
+const results = require('./results');
+const jobs = require('./jobs');
 
 router.get('/', function (req, res, next) {
     res.render('index', {title: 'Express'});
 });
 
-router.post('/submit', function (req, res, next) {
-    let result = "";
-    const randomNum = Math.floor(Math.random() * 10000);
-    try {
-        if (!fs.existsSync(__dirname + '/../testenv')) fs.mkdirSync(__dirname + '/../testenv');
-    } catch (e) {
-        console.error(e.message);
+// Sélection d'un sous-ensemble de tests : noms et/ou tags séparés par des virgules
+const FILTER_RE = /^[A-Za-z0-9_,]+$/;
+
+function testArgs(body) {
+    let args = [];
+    if (typeof body.tests === 'string' && FILTER_RE.test(body.tests)) args.push('-n ' + body.tests);
+    if (typeof body.tags === 'string' && FILTER_RE.test(body.tags)) args.push('-t ' + body.tags);
+    return args.join(' ');
+}
+
+const TESTENV = path.join(__dirname, '..', 'testenv');
+
+function sourceHash(data) {
+    return crypto.createHash('sha1').update(data).digest('hex').slice(0, 16);
+}
+
+// Une commande `make` : sortie complète, y compris en cas d'échec, et durée en ms
+function run(cmd) {
+    const start = Date.now();
+    return new Promise(function (resolve) {
+        child_process.exec(cmd, {cwd: TESTENV, maxBuffer: 64 << 20}, function (err, stdout, stderr) {
+            if (err) console.error(err.message);
+            resolve({ok: !err, ms: Date.now() - start, output: stdout + (err && stderr ? stderr + "\n\n" : '')});
+        });
+    });
+}
+
+// File d'attente : les tâches passent une à une, dans l'ordre d'arrivée
+function queue() {
+    let tail = Promise.resolve();
+    return function (job) {
+        const done = tail.then(job);
+        tail = done.catch(() => {});
+        return done;
+    };
+}
+
+// Les paliers de correction partagent les binaires de testenv (assertions,
+// run_scenarios) : une soumission à la fois. Les paliers lourds travaillent
+// dans cache/, sur leur propre file, pendant que les suivantes sont corrigées.
+const correctionQueue = queue(), heavyQueue = queue();
+
+// Un test qui échoue sort avec le code 1 ; tout autre échec de make est un plantage
+const CRASH_RE = /^make: \*\*\* \[.*\] (?!Error 1$).*$/m;
+// Rapports des sanitizers comptés par runmatrix, variante par variante
+const SANITIZER_RE = /=== Variante \S+ : .*, [1-9]\d* rapport\(s\) ===/;
+const PASSED_RE = /(\d+)\/(\d+) (tests|scénarios) passés/g;
+const FAILING_RE = /^Catégories échouées : (.*)$/gm;
+
+// Tests qui échouent aussi sur le moteur de référence (testenv/reference) :
+// seuls ceux-là peuvent échouer sans bloquer les paliers lourds
+const KNOWN_FAILURES = new Set([
+    'test_swap_logic',
+    'test_complex_chain_bounce',
+    'test_swap_integrity',
+    'test_empty_line_selection',
+]);
+
+// Palier de tests : pas de plantage, pas de rapport de sanitizer, tous les
+// scénarios et tous les tests réussis hors KNOWN_FAILURES, dans chaque
+// variante ; la raison d'un échec est ajoutée à la sortie
+function testsPassed(r) {
+    if (CRASH_RE.test(r.output)) return false;
+    if (SANITIZER_RE.test(r.output)) {
+        r.output += '\n\x1b[101mRapport de sanitizer : paliers lourds bloqués.\x1b[0m\n';
+        return false;
     }
-    try {
-        fs.writeFileSync(path.join(__dirname, '..', 'testenv', 'temp' + randomNum + '.c'), req.body.data);
+    const failing = new Set();
+    for (const m of r.output.matchAll(FAILING_RE))
+        for (const name of m[1].split(',')) failing.add(name.trim());
+    const unexpected = [...failing].filter(name => !KNOWN_FAILURES.has(name));
+    let complete = false;
+    for (const m of r.output.matchAll(PASSED_RE)) {
+        const failed = m[2] - m[1];
+        if (m[3] === 'scénarios' ? failed > 0 : failed > KNOWN_FAILURES.size) {
+            complete = false;
+            break;
+        }
+        complete = true;
+    }
+    if (unexpected.length === 0 && complete) return true;
+    r.output += '\n\x1b[101mTests échoués hors de ceux de la référence' +
+        (unexpected.length ? ` (${unexpected.join(', ')})` : '') + ' : paliers lourds bloqués.\x1b[0m\n';
+    return false;
+}
 
-    } catch (err) {
-        console.error(err.message);
-        return;
+const CORRECTION_TIERS = [
+    // le moteur est aussi compilé sous sanitizers (make matrix), en parallèle
+    {key: 'compile', name: 'Compilation', cmd: (src, body) => `make -k BOARD_SRCS=${src} assertions run_scenarios matrix`},
+    {key: 'smoke', name: 'Smoke', cmd: (src, body) => `make -o assertions -o run_scenarios BOARD_SRCS=${src} runsmoke`},
+    {
+        key: 'tests', name: 'Tests complets',
+        cmd: (src, body) => `make -k -o assertions -o run_scenarios BOARD_SRCS=${src} TEST_ARGS="${testArgs(body)}" runtests runscenarios runsymmetry runmatrix`,
+        // les tests de KNOWN_FAILURES peuvent échouer sans bloquer la suite
+        passed: testsPassed,
+    },
+];
+
+const HEAVY_TIERS = [
+    // tous les placements de départ, en quelques dizaines de secondes
+    {
+        key: 'exhaustive', name: 'Placement exhaustif',
+        cmd: (src, body, id) => `make -s runsetupcheck BOARD_SRCS=${src} SETUPCHECK_BIN=cache/${id}-setupcheck`,
+    },
+    {
+        key: 'fuzz', name: 'Fuzzing',
+        cmd: (src, body, id) => `make -s runfuzz BOARD_SRCS=${src} FUZZ_TIME=10 FUZZ_BIN=cache/${id}-fuzz ` +
+            `FUZZ_CORPUS=cache/${id}.corpus FUZZ_ARTIFACTS=cache`,
+    },
+    {key: 'bench', name: 'Mesures (build -O2)', cmd: (src, body) => `make -s runbench BOARD_SRCS=${src}`},
+];
+
+const NB_TIERS = CORRECTION_TIERS.length + HEAVY_TIERS.length;
+
+// Étalonnage de la machine (moteur de référence, voir testenv/Makefile) au
+// démarrage puis périodiquement, dans la file des paliers lourds : jamais
+// pendant une mesure, et toujours avant la première
+const CALIBRATION_MS = 30 * 60 * 1000;
+
+async function calibrate() {
+    const r = await run('make -s calibrate');
+    const perf = r.output.match(/Performance : (\d+) nœuds\/s/);
+    if (!r.ok || !perf) return console.error('étalonnage impossible');
+    const noise = r.output.match(/Bruit : ([\d.]+) %/);
+    console.log(`étalonnage : ${perf[1]} nœuds/s pour la référence` + (noise ? `, bruit ${noise[1]} %` : ''));
+}
+
+heavyQueue(calibrate);
+setInterval(() => heavyQueue(calibrate), CALIBRATION_MS).unref();
+
+// Noms des catégories de tests sélectionnées par la soumission
+async function listCategories(body) {
+    const r = await run(`./assertions -l ${testArgs(body)}`);
+    return r.ok ? r.output.split('\n').filter(line => line).map(line => line.split('\t')[0]) : [];
+}
+
+// Exécute des paliers dans l'ordre et publie chacun dès qu'il est fini ; s'arrête au premier échec
+async function runTiers(tiers, sub) {
+    for (const tier of tiers) {
+        const index = sub.done++;
+        jobs.write(sub.job, `\x1b[48;2;100;100;200m=== Palier ${index + 1}/${NB_TIERS} : ${tier.name} ===\x1b[0m\n`);
+        const r = await run(tier.cmd(sub.src, sub.body, sub.id));
+        const passed = tier.passed ? tier.passed(r) : r.ok;
+        sub.outputs[tier.key] = r.output;
+        sub.timings[tier.key + '_ms'] = r.ms;
+        sub.tiers[tier.key] = passed;
+        if (tier.key === 'tests') sub.categories = await listCategories(sub.body);
+        if (tier.key === 'fuzz' && !passed) {
+            // l'entrée fautive, rejouée appel par appel
+            const crash = r.output.match(/sauvegardée dans (\S+)/);
+            if (crash) r.output += (await run(`cache/${sub.id}-fuzz ${crash[1]}`)).output;
+        }
+        if (tier.key === 'bench' && passed) {
+            const regression = results.recordBench(sub.body, sub.id, r.output, {bench_ms: r.ms});
+            if (regression)
+                r.output += `\n\x1b[101mRégression : ${Math.round(regression.drop * 100)} % de performance en moins ` +
+                    `que la version précédente (${regression.nodes_per_s} nœuds/s` +
+                    (regression.index ? `, indice ${regression.index}` : '') + `).\x1b[0m\n`;
+        }
+        jobs.write(sub.job, r.output);
+        if (!passed) {
+            jobs.write(sub.job, `\n\x1b[91m ❌ ${tier.name} : échec (${r.ms} ms), paliers suivants annulés\x1b[0m\n`);
+            return false;
+        }
+        jobs.write(sub.job, `\n\x1b[92m ✅ ${tier.name} : ${r.ms} ms\x1b[0m\n\n`);
     }
-    try {
-        let output = child_process.execSync(`make BOARD_SRCS=${path.join(__dirname, '..', 'testenv', 'temp' + randomNum + '.c')}`, {
-            cwd: path.join(__dirname, '..', 'testenv'),
-        });
-        result += output.toString();
+    return true;
+}
+
+const HASH_RE = /^[0-9a-f]{16}$/;
 
-        fs.unlinkSync(path.join(__dirname, '..', 'testenv', 'temp' + randomNum + '.o'));
+// Met la soumission en file et rend aussitôt l'identifiant du travail (voir
+// jobs.js). Le source peut être annoncé par son empreinte seule ({hash}) :
+// une correction en cours ou récente des mêmes source et options est rendue
+// telle quelle (200), un source déjà reçu est recorrigé sans envoi (202) ;
+// sinon 404, et le client envoie {data}. force: true relance une correction.
+router.post('/submit', function (req, res, next) {
+    const body = req.body;
+    const id = typeof body.data === 'string' ? sourceHash(body.data) : body.hash;
+    if (typeof id !== 'string' || !HASH_RE.test(id)) return res.status(400).send('source manquant\n');
+    const key = [id, typeof body.student === 'string' ? body.student : '', testArgs(body)].join('\n');
+    const known = body.force ? undefined : jobs.lookup(key);
+    if (known) return res.status(200).location('/jobs/' + known.id).json({job: known.id, cached: true});
 
+    const src = path.join(TESTENV, 'cache', id + '.c');
+    if (typeof body.data === 'string') {
+        try {
+            fs.mkdirSync(path.dirname(src), {recursive: true});
+            fs.writeFileSync(src, body.data);
+        } catch (err) {
+            console.error(err.message);
+            return res.status(500).send(err.message);
+        }
+    } else if (!fs.existsSync(src)) {
+        return res.status(404).json({error: 'source inconnu, à envoyer dans data'});
+    }
+    const job = jobs.create(key);
+    res.status(202).location('/jobs/' + job.id).json({job: job.id});
+    grade({id: id, src: src, body: body, job: job, done: 0, outputs: {}, timings: {}, tiers: {}, categories: []});
+});
 
+async function grade(sub) {
+    try {
+        const passed = await correctionQueue(function () {
+            jobs.start(sub.job);
+            return runTiers(CORRECTION_TIERS, sub);
+        });
+        if (passed) await heavyQueue(() => runTiers(HEAVY_TIERS, sub));
+        results.recordSubmission(sub.body, sub.id, sub.outputs.tests || '', sub.categories, sub.timings, sub.tiers);
     } catch (err) {
         console.error(err.message);
-        console.error(err.stdout ? err.stdout.toString() : '');
-        console.error(err.stderr ? err.stderr.toString() : '');
-        result += err.stdout ? err.stdout.toString() + "\n\n" : '';
-        result += err.stderr ? err.stderr.toString() + "\n\n" : '';
-    } finally {
-        fs.unlinkSync(path.join(__dirname, '..', 'testenv', 'temp' + randomNum + '.c'));
-        try {
-            fs.unlinkSync(path.join(__dirname, '..', 'testenv', 'temp' + randomNum + '.o'));
-        } catch (e) {
-            console.error(e.message);
-        }
+        jobs.write(sub.job, `\n\x1b[91m ❌ Erreur interne : ${err.message}\x1b[0m\n`);
     }
-    res.send(result);
-})
+    jobs.finish(sub.job, sub.tiers, sub.timings);
+}
+
 module.exports = router;
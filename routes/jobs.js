@@ -0,0 +1,137 @@
+const express = require('express');
+const router = express.Router();
+const crypto = require('crypto');
+
+// Corrections en cours et récentes. Une soumission crée un travail et rend son
+// identifiant tout de suite ; la sortie des paliers s'y accumule et se lit
+// ensuite par GET /jobs/:id (instantané ou attente longue avec ?from=&wait=)
+// ou par GET /jobs/:id/events (Server-Sent Events, reprise par Last-Event-ID).
+// Les décalages sont des positions dans la sortie.
+const jobs = new Map();
+// Dernier travail de chaque clé (empreinte du source et options), pour ne pas
+// recorriger une soumission identique
+const byKey = new Map();
+
+// Durée de conservation d'un travail terminé
+const JOB_TTL_MS = 60 * 60 * 1000;
+// Attente maximale d'une requête longue, sous les délais usuels des proxys
+const MAX_WAIT_S = 25;
+// Commentaire SSE périodique : la connexion reste active derrière un proxy
+const KEEPALIVE_MS = 15 * 1000;
+
+const ID_RE = /^[0-9a-f]{16}$/;
+
+function create(key) {
+    const job = {
+        id: crypto.randomBytes(8).toString('hex'), key: key, status: 'queued', created: new Date().toISOString(),
+        finished: null, output: '', tiers: {}, timings: {}, listeners: new Set(),
+    };
+    jobs.set(job.id, job);
+    byKey.set(key, job);
+    return job;
+}
+
+function lookup(key) {
+    return byKey.get(key);
+}
+
+function notify(job) {
+    for (const listener of job.listeners) listener();
+}
+
+function write(job, text) {
+    job.output += text;
+    notify(job);
+}
+
+function start(job) {
+    job.status = 'running';
+    notify(job);
+}
+
+function finish(job, tiers, timings) {
+    job.status = 'done';
+    job.finished = new Date().toISOString();
+    job.tiers = tiers;
+    job.timings = timings;
+    notify(job);
+    setTimeout(function () {
+        jobs.delete(job.id);
+        if (byKey.get(job.key) === job) byKey.delete(job.key);
+    }, JOB_TTL_MS).unref();
+}
+
+function snapshot(job, from) {
+    return {
+        id: job.id, status: job.status, created: job.created, finished: job.finished,
+        tiers: job.tiers, timings: job.timings, from: from, next: job.output.length, output: job.output.slice(from),
+    };
+}
+
+function find(req, res) {
+    const job = ID_RE.test(req.params.id) ? jobs.get(req.params.id) : undefined;
+    if (!job) res.status(404).json({error: 'travail inconnu ou expiré'});
+    return job;
+}
+
+function offset(value, job) {
+    const n = parseInt(value, 10);
+    return n >= 0 && n <= job.output.length ? n : 0;
+}
+
+// État et sortie depuis ?from ; avec ?wait=s, attend de la nouvelle sortie ou la fin
+router.get('/:id', function (req, res, next) {
+    const job = find(req, res);
+    if (!job) return;
+    const from = offset(req.query.from, job);
+    const wait = Math.min(parseInt(req.query.wait, 10) || 0, MAX_WAIT_S);
+    if (wait <= 0 || job.output.length > from || job.status === 'done') return res.json(snapshot(job, from));
+
+    const reply = function () {
+        clearTimeout(timer);
+        job.listeners.delete(reply);
+        res.json(snapshot(job, from));
+    };
+    const timer = setTimeout(reply, wait * 1000);
+    job.listeners.add(reply);
+    res.on('close', () => {
+        clearTimeout(timer);
+        job.listeners.delete(reply);
+    });
+});
+
+// Flux SSE : événements « status » (queued, running), « output » (texte en
+// JSON, id = décalage après le morceau), puis « done » avec les paliers
+router.get('/:id/events', function (req, res, next) {
+    const job = find(req, res);
+    if (!job) return;
+    let sent = offset(req.get('Last-Event-ID') || req.query.from, job), status = null;
+    res.set({'Content-Type': 'text/event-stream; charset=utf-8', 'Cache-Control': 'no-cache', 'X-Accel-Buffering': 'no'});
+    res.flushHeaders();
+
+    const keepalive = setInterval(() => res.write(': \n\n'), KEEPALIVE_MS);
+    const close = function () {
+        clearInterval(keepalive);
+        job.listeners.delete(flush);
+    };
+    const flush = function () {
+        if (job.status !== status && job.status !== 'done') {
+            status = job.status;
+            res.write(`event: status\ndata: ${JSON.stringify(status)}\n\n`);
+        }
+        if (job.output.length > sent) {
+            res.write(`event: output\nid: ${job.output.length}\ndata: ${JSON.stringify(job.output.slice(sent))}\n\n`);
+            sent = job.output.length;
+        }
+        if (job.status === 'done') {
+            res.write(`event: done\ndata: ${JSON.stringify({tiers: job.tiers, timings: job.timings})}\n\n`);
+            close();
+            res.end();
+        }
+    };
+    job.listeners.add(flush);
+    res.on('close', close);
+    flush();
+});
+
+module.exports = {router, create, lookup, write, start, finish};
@@ -0,0 +1,190 @@
+const express = require('express');
+const router = express.Router();
+const fs = require('fs');
+const path = require('path');
+
+// Historique des soumissions : un journal en ajout seul (une ligne JSON par
+// événement) et un index en mémoire reconstruit au démarrage en une lecture.
+//   {type: 'submit', student, hash, date, tiers, tests, scenarios, categories, timings}
+//   {type: 'bench', student, hash, date, nodes_per_s, depth, index, noise, timings, regression}
+// Les mesures sont enregistrées à part, dès leur palier fini : deux
+// enregistrements par soumission, reliés par l'empreinte du source.
+const DATA_DIR = path.join(__dirname, '..', 'data');
+const LOG = path.join(DATA_DIR, 'results.log');
+
+// Baisse des nœuds/s au-delà de laquelle une nouvelle version est signalée
+const REGRESSION = 0.2;
+
+// index : nœuds/s rapportés à ceux du moteur de référence sur la même machine
+// (make calibrate, voir testenv/ai.c), comparable d'un serveur ou d'une charge
+// à l'autre ; noise : écart-type relatif des dernières parties mesurées
+
+const STUDENT_RE = /^[A-Za-z0-9_.-]{1,64}$/;
+// Soumissions sans nom d'élève valide : plusieurs élèves sous un même nom,
+// sans historique comparable ni place dans le nombre d'élèves du jour
+const ANONYMOUS = 'anonyme';
+
+const byStudent = new Map(); // élève -> positions des enregistrements dans le journal
+const byDay = new Map();     // jour -> agrégats de la promotion
+let logSize = 0;
+
+function dayOf(entry) {
+    return entry.date.slice(0, 10);
+}
+
+function indexEntry(entry, offset) {
+    if (!byStudent.has(entry.student)) byStudent.set(entry.student, []);
+    byStudent.get(entry.student).push(offset);
+
+    if (!byDay.has(dayOf(entry)))
+        byDay.set(dayOf(entry), {submissions: 0, students: new Set(), passed: 0, total: 0, nodes: [], indexes: []});
+    const day = byDay.get(dayOf(entry));
+    if (entry.student !== ANONYMOUS) day.students.add(entry.student);
+    if (entry.type === 'submit') {
+        day.submissions++;
+        if (entry.tests) {
+            day.passed += entry.tests.passed;
+            day.total += entry.tests.total;
+        }
+    } else if (entry.type === 'bench' && entry.nodes_per_s) {
+        day.nodes.push(entry.nodes_per_s);
+        if (entry.index) day.indexes.push(entry.index);
+    }
+}
+
+function load() {
+    let data;
+    try {
+        data = fs.readFileSync(LOG);
+    } catch (e) {
+        return;
+    }
+    let offset = 0;
+    while (offset < data.length) {
+        let end = data.indexOf(10, offset);
+        // dernière ligne tronquée (arrêt pendant une écriture) : ignorée
+        if (end < 0) break;
+        try {
+            indexEntry(JSON.parse(data.toString('utf8', offset, end)), offset);
+        } catch (e) {
+            console.error('results.log: ligne illisible à l\'octet ' + offset);
+        }
+        offset = end + 1;
+    }
+    logSize = offset;
+}
+
+function readAt(fd, offset) {
+    let chunk = Buffer.alloc(4096), line = Buffer.alloc(0);
+    for (let pos = offset; ; pos += chunk.length) {
+        const n = fs.readSync(fd, chunk, 0, chunk.length, pos);
+        const end = chunk.subarray(0, n).indexOf(10);
+        line = Buffer.concat([line, chunk.subarray(0, end < 0 ? n : end)]);
+        if (end >= 0 || n === 0) return JSON.parse(line.toString());
+    }
+}
+
+function append(entry) {
+    const line = Buffer.from(JSON.stringify(entry) + '\n');
+    try {
+        fs.mkdirSync(DATA_DIR, {recursive: true});
+        fs.appendFileSync(LOG, line);
+    } catch (err) {
+        console.error(err.message);
+        return;
+    }
+    indexEntry(entry, logSize);
+    logSize += line.length;
+}
+
+function history(student) {
+    const offsets = byStudent.get(student) || [];
+    if (offsets.length === 0) return [];
+    const fd = fs.openSync(LOG, 'r');
+    try {
+        return offsets.map(offset => readAt(fd, offset));
+    } finally {
+        fs.closeSync(fd);
+    }
+}
+
+function student(body) {
+    return typeof body.student === 'string' && STUDENT_RE.test(body.student) ? body.student : ANONYMOUS;
+}
+
+const ANSI_RE = /\x1b\[[0-9;]*m/g;
+
+// Résumé d'une sortie de `make` : compteurs des tests et scénarios, catégories
+// (noms du registre de assertions) en échec ou réussies
+function parseTests(output, categories) {
+    const text = output.replace(ANSI_RE, '');
+    const tests = text.match(/(\d+)\/(\d+) tests passés/);
+    const scenarios = text.match(/(\d+)\/(\d+) scénarios passés/);
+    const failing = text.match(/Catégories échouées : (.*)/);
+    const failed = new Set(failing ? failing[1].trim().split(',') : []);
+    let result = {};
+    for (const name of categories) result[name] = !failed.has(name);
+    return {
+        tests: tests ? {passed: +tests[1], total: +tests[2]} : null,
+        scenarios: scenarios ? {passed: +scenarios[1], total: +scenarios[2]} : null,
+        categories: result,
+    };
+}
+
+function recordSubmission(body, hash, output, categories, timings, tiers) {
+    append(Object.assign({type: 'submit', student: student(body), hash: hash, date: new Date().toISOString(), tiers: tiers},
+        parseTests(output, categories), {timings: timings}));
+}
+
+// Enregistre les mesures d'une version et les compare à la précédente version
+// mesurée du même élève, par l'indice quand les deux en ont un (sinon les
+// nœuds/s bruts) ; retourne la régression éventuelle, jamais pour ANONYMOUS
+function recordBench(body, hash, output, timings) {
+    const text = output.replace(ANSI_RE, '');
+    const perf = text.match(/Performance : (\d+) nœuds\/s, profondeur moyenne ([\d.]+)/);
+    const index = text.match(/Indice : ([\d.]+) × le moteur de référence/);
+    const noise = text.match(/Bruit : ([\d.]+) %/);
+    const name = student(body);
+    const entry = {
+        type: 'bench', student: name, hash: hash, date: new Date().toISOString(),
+        nodes_per_s: perf ? +perf[1] : null, depth: perf ? +perf[2] : null,
+        index: index ? +index[1] : null, noise: noise ? +noise[1] / 100 : null, timings: timings, regression: null,
+    };
+    if (entry.nodes_per_s && name !== ANONYMOUS) {
+        const previous = history(name).reverse().find(e => e.type === 'bench' && e.nodes_per_s && e.hash !== hash);
+        const key = previous && previous.index && entry.index ? 'index' : 'nodes_per_s';
+        if (previous && entry[key] < previous[key] * (1 - REGRESSION))
+            entry.regression = {
+                hash: previous.hash, nodes_per_s: previous.nodes_per_s, index: previous.index || null,
+                drop: +(1 - entry[key] / previous[key]).toFixed(3),
+            };
+    }
+    append(entry);
+    return entry.regression;
+}
+
+// Tendances de la promotion, par jour
+router.get('/', function (req, res, next) {
+    const days = [...byDay.keys()].sort().map(function (day) {
+        const d = byDay.get(day);
+        const nodes = [...d.nodes].sort((a, b) => a - b);
+        const indexes = [...d.indexes].sort((a, b) => a - b);
+        return {
+            day: day, submissions: d.submissions, students: d.students.size,
+            pass_rate: d.total ? +(d.passed / d.total).toFixed(3) : null,
+            median_nodes_per_s: nodes.length ? nodes[nodes.length >> 1] : null,
+            median_index: indexes.length ? indexes[indexes.length >> 1] : null,
+        };
+    });
+    res.json(days);
+});
+
+// Historique d'un élève, dans l'ordre des soumissions
+router.get('/:student', function (req, res, next) {
+    if (!STUDENT_RE.test(req.params.student)) return res.status(400).json({error: 'nom invalide'});
+    res.json(history(req.params.student));
+});
+
+load();
+
+module.exports = {router, recordSubmission, recordBench};
@@ -0,0 +1,216 @@
+#define _GNU_SOURCE
+#include "board.h"
+#include "search.h"
+#include "turns.h"
+#include <math.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Mesure de performance sous une charge de recherche réaliste.
+ *
+ * Depuis le placement standard, les deux joueurs jouent une partie dont
+ * chaque tour est choisi par la recherche alpha-bêta (search.h) avec un
+ * budget de temps fixe. On affiche par tour la profondeur atteinte et les
+ * nœuds par seconde, puis un score de performance : la moyenne des nœuds
+ * par seconde sur la partie.
+ *
+ * Pour une mesure comparable (make runbench, make calibrate), -p épingle le
+ * processus sur un processeur et -r rejoue la partie, table de transposition
+ * vidée, après une partie de chauffe non comptée (caches, pages de la
+ * table), jusqu'à ce que l'écart-type relatif des STABLE_RUNS dernières
+ * parties passe sous -v % (au plus -r parties) : le score est leur moyenne,
+ * suivi d'une ligne « Bruit ». Au-delà de -r parties, la mesure est signalée
+ * instable (machine chargée). Avec -b, le score est aussi donné en indice :
+ * rapport aux nœuds par seconde du moteur de référence, lus dans la sortie
+ * de ai mesurée sur la même machine (make calibrate).
+ *   ./ai [-t ms_par_tour] [-n tours] [-j threads] [-m Mo_table]
+ *        [-p processeur] [-r parties_max] [-v bruit_%] [-b référence.txt]
+ */
+
+#define STABLE_RUNS 3
+
+typedef struct game_stats_s {
+  unsigned long nodes;
+  double seconds;
+  int played;
+  int depth_sum;
+} game_stats;
+
+static void print_turn(const turn *t) {
+  for (int i = 0; i < t->nb_steps; i++) {
+    const step *s = &t->steps[i];
+    if (s->call == CALL_PICK)
+      printf("pick(%d,%d)", s->b, s->c);
+    else if (s->call == CALL_MOVE)
+      printf(" %c", "GSNEW"[s->a]);
+    else if (s->call == CALL_SWAP)
+      printf(" swap(%d,%d)", s->a, s->b);
+  }
+}
+
+/* Une partie depuis le placement standard ; verbose affiche chaque tour */
+static game_stats play_game(const search_options *opt, int nb_turns, int verbose) {
+  game_stats st = {0, 0, 0, 0};
+  board g = new_game();
+  for (int c = 0; c < DIMENSION; c++)
+    if (standard_piece(c) != NONE) {
+      place_piece(g, standard_piece(c), SOUTH_P, c);
+      place_piece(g, standard_piece(c), NORTH_P, c);
+    }
+
+  if (verbose)
+    printf("%-5s %-6s %10s %12s %8s  %s\n", "tour", "joueur", "profondeur", "nœuds/s", "score", "coup");
+  player p = SOUTH_P;
+  for (int n = 0; n < nb_turns && get_winner(g) == NO_PLAYER; n++) {
+    search_result r = search_best_turn(g, p, opt);
+    st.nodes += r.nodes;
+    st.seconds += r.seconds;
+    if (!r.has_move) {
+      if (verbose)
+        printf("%-5d %-6s aucun tour possible\n", n + 1, p == SOUTH_P ? "SUD" : "NORD");
+      break;
+    }
+    if (verbose) {
+      printf("%-5d %-6s %10d %12.0f %8d  ", n + 1, p == SOUTH_P ? "SUD" : "NORD", r.depth,
+             r.seconds > 0 ? r.nodes / r.seconds : 0, r.score);
+      print_turn(&r.best);
+      printf("\n");
+    }
+    if (play_turn(g, &r.best) != OK) {
+      printf("%s ❌ le moteur refuse de rejouer le tour qu'il a lui-même généré%s\n", RED, RESET);
+      break;
+    }
+    st.played++;
+    st.depth_sum += r.depth;
+    p = next_player(p);
+  }
+  if (verbose && get_winner(g) != NO_PLAYER)
+    printf("\n%sVictoire de %s.%s\n", GREEN, get_winner(g) == SOUTH_P ? "SUD" : "NORD", RESET);
+  destroy_game(g);
+  return st;
+}
+
+/* Moyenne et écart-type relatif des n dernières mesures */
+static double recent_mean(const double *v, int n, double *noise) {
+  double sum = 0, sq = 0;
+  for (int i = 0; i < n; i++)
+    sum += v[i];
+  double mean = sum / n;
+  for (int i = 0; i < n; i++)
+    sq += (v[i] - mean) * (v[i] - mean);
+  *noise = mean > 0 ? sqrt(sq / n) / mean : 0;
+  return mean;
+}
+
+/* Score « Performance » d'une sortie de ai, 0 s'il n'y est pas */
+static double read_reference(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (f == NULL) {
+    perror(path);
+    return 0;
+  }
+  char line[256];
+  double rate = 0;
+  while (fgets(line, sizeof(line), f)) {
+    char *p = strstr(line, "Performance : ");
+    if (p != NULL)
+      rate = atof(p + strlen("Performance : "));
+  }
+  fclose(f);
+  return rate;
+}
+
+/* Épingle le processus, et les threads qu'il créera, sur un processeur */
+static void pin_cpu(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) < 0)
+    perror("sched_setaffinity");
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-t ms_per_turn] [-n turns] [-j threads] [-m tt_mb] [-p cpu] [-r max_runs] [-v noise_pct]\n"
+                  "       %*s [-b reference.txt]\n",
+          prog, (int)strlen(prog), "");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  search_options opt = {200, 0, (int)sysconf(_SC_NPROCESSORS_ONLN)};
+  int nb_turns = 10, tt_mb = 64, cpu = -1, max_runs = 1;
+  double max_noise = 2, reference = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      opt.time_ms = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      nb_turns = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      opt.threads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+      tt_mb = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+      cpu = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+      max_runs = atoi(argv[++i]) > 0 ? atoi(argv[i]) : 1;
+    else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc)
+      max_noise = atof(argv[++i]);
+    else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+      reference = read_reference(argv[++i]);
+    else
+      usage(argv[0]);
+  }
+  if (cpu >= 0)
+    pin_cpu(cpu);
+
+  printf("%s=== RECHERCHE ALPHA-BÊTA (%d ms/tour, %d threads%s) ===%s\n\n", BGBLUE, opt.time_ms, opt.threads,
+         cpu >= 0 ? ", épinglé" : "", RESET);
+  double rates[64];
+  if (max_runs > 64)
+    max_runs = 64;
+  game_stats st = {0, 0, 0, 0};
+  double rate = 0, noise = 0;
+  int runs = 0;
+  if (max_runs > 1) {
+    search_init(tt_mb);
+    play_game(&opt, nb_turns, 0);
+    search_free();
+  }
+  while (runs < max_runs) {
+    search_init(tt_mb);
+    st = play_game(&opt, nb_turns, runs == 0);
+    search_free();
+    rates[runs++] = st.seconds > 0 ? st.nodes / st.seconds : 0;
+    if (max_runs > 1)
+      printf("%spartie %d : %.0f nœuds/s%s\n", BLUE, runs, rates[runs - 1], RESET);
+    int n = runs < STABLE_RUNS ? runs : STABLE_RUNS;
+    rate = recent_mean(rates + runs - n, n, &noise);
+    if (runs >= STABLE_RUNS && noise * 100 <= max_noise)
+      break;
+  }
+
+  printf("\n%sPerformance : %.0f nœuds/s, profondeur moyenne %.2f sur %d tours.%s\n", bgyellow, rate,
+         st.played ? (double)st.depth_sum / st.played : 0, st.played, RESET);
+  if (max_runs > 1) {
+    int stable = runs >= STABLE_RUNS && noise * 100 <= max_noise;
+    printf("%sBruit : %.1f %% sur les %d dernières parties (%d jouées)%s\n", stable ? BLUE : RED, noise * 100,
+           runs < STABLE_RUNS ? runs : STABLE_RUNS, runs, RESET);
+    if (!stable)
+      printf("%s ⚠ mesure instable au-delà de %.1f %% : machine chargée, score à confirmer%s\n", RED, max_noise, RESET);
+  }
+  if (reference > 0)
+    printf("%sIndice : %.3f × le moteur de référence (%.0f nœuds/s sur cette machine)%s\n", bgyellow,
+           rate / reference, reference, RESET);
+  return 0;
+}
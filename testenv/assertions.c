@@ -1,6 +1,10 @@
 #include "board.h"
+#include "snapshot.h"
+#include "tracer.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #define RED "\033[91m"
 #define GREEN "\033[92m"
@@ -14,6 +18,7 @@
 
 static int total = 0;
 static int failed = 0;
+static int quiet = 0; /* -q : n'affiche que les échecs */
 
 #define PRINT_VALUE(val) _Generic((val), \
     int: "%d",                           \
@@ -35,24 +40,86 @@ static int failed = 0;
     if (!(cond)) {                                                    \
       failed++;                                                       \
       printf("%s ❌ FAIL: %s%s\n", RED, msg, RESET);                  \
+      fflush(stdout);                                                 \
+      trace_dump(STDOUT_FILENO, "échec");                             \
       printf("%s      -> Expected: ", RED);                           \
       printf(PRINT_VALUE(expected), expected);                        \
       printf("\n\n");                                                 \
       return 0;                                                       \
-    } else {                                                          \
+    } else if (!quiet) {                                              \
       printf("%s ✅ PASS: %s%s\n", GREEN, msg, RESET);                \
       printf("%s      -> Got: %s", GREEN, darkgreen);                 \
       printf(PRINT_VALUE(expected), expected);                        \
     }                                                                 \
-    printf("\n%s========= TEST : %s%s\n\n\n", darkgreen, msg, RESET); \
+    if (!quiet)                                                       \
+      printf("\n%s========= TEST : %s%s\n\n\n", darkgreen, msg, RESET); \
   } while (0)
 
 #define CATPASS(msg)                                                                                                 \
   do {                                                                                                               \
-    printf("%s================\n 💙 CATEGORY PASS: %s%s\n%s================%s\n", BLUE, DARKBLUE, msg, BLUE, RESET); \
+    if (!quiet)                                                                                                      \
+      printf("%s================\n 💙 CATEGORY PASS: %s%s\n%s================%s\n", BLUE, DARKBLUE, msg, BLUE, RESET); \
     return 1;                                                                                                        \
   } while (0)
 
+/* --- REGISTRE DES TESTS --- */
+/* Chaque TEST s'inscrit tout seul au chargement, avec ses tags séparés par des virgules */
+
+#define MAX_TESTS 64
+
+typedef struct test_entry_s {
+  const char *name;
+  const char *tags;
+  int (*fn)(void);
+} test_entry;
+
+static test_entry registry[MAX_TESTS];
+static int nb_tests = 0;
+
+static void register_test(const char *name, const char *tags, int (*fn)(void)) {
+  if (nb_tests < MAX_TESTS)
+    registry[nb_tests++] = (test_entry){name, tags, fn};
+}
+
+#define TEST(fn, tags)                                           \
+  int fn(void);                                                  \
+  __attribute__((constructor)) static void register_##fn(void) { \
+    register_test(#fn, tags, fn);                                \
+  }                                                              \
+  int fn(void)
+
+/* Vrai si item apparaît dans la liste list (séparée par des virgules) */
+static int in_list(const char *list, const char *item) {
+  size_t len = strlen(item);
+  for (const char *p = list; *p;) {
+    const char *end = strchr(p, ',');
+    size_t n = end ? (size_t)(end - p) : strlen(p);
+    if (n == len && strncmp(p, item, n) == 0)
+      return 1;
+    if (!end)
+      break;
+    p = end + 1;
+  }
+  return 0;
+}
+
+/* Un test est retenu si son nom (avec ou sans « test_ ») est dans names,
+   ou si l'un de ses tags est dans tags. Sans filtre, tout est retenu. */
+static int selected(const test_entry *t, const char *names, const char *tags) {
+  if (!names && !tags)
+    return 1;
+  if (names && (in_list(names, t->name) || in_list(names, t->name + strlen("test_"))))
+    return 1;
+  if (tags) {
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", t->tags);
+    for (char *tag = strtok(buf, ","); tag; tag = strtok(NULL, ","))
+      if (in_list(tags, tag))
+        return 1;
+  }
+  return 0;
+}
+
 /* --- HELPER FUNCTION --- */
 /* Remplit le plateau pour passer la phase de setup rapidement */
 void helper_setup_game(board g) {
@@ -72,9 +139,20 @@ void helper_setup_game(board g) {
   place_piece(g, THREE, SOUTH_P, 5);
 }
 
+/* Setup puis un premier échange : SOUTH avance (0,0) en (1,0), NORTH avance (5,0) en (4,0) */
+void helper_opening(board g) {
+  helper_setup_game(g);
+  pick_piece(g, SOUTH_P, 0, 0);
+  move_piece(g, NORTH);
+  pick_piece(g, NORTH_P, 5, 0);
+  move_piece(g, SOUTH);
+}
+
+/* Les tests partent des positions de snapshot.h : construites une fois, puis copiées */
+
 /* --- TESTS DE BASE --- */
 
-int test_structure_basics(void) {
+TEST(test_structure_basics, "Basic,Smoke") {
   ASSERT(next_player(SOUTH_P) == NORTH_P, next_player(SOUTH_P), "Next player SOUTH -> NORTH");
   ASSERT(next_player(NORTH_P) == SOUTH_P, next_player(NORTH_P), "Next player NORTH -> SOUTH");
 
@@ -88,7 +166,7 @@ int test_structure_basics(void) {
 
 /* --- TESTS DE SETUP ET LIMITES --- */
 
-int test_setup_limits(void) {
+TEST(test_setup_limits, "Setup,Smoke") {
   board g = new_game();
 
   // 1. Placement hors zone
@@ -111,19 +189,11 @@ int test_setup_limits(void) {
 
 /* --- TESTS DE LOGIQUE DE SÉLECTION (Rule of closest line) --- */
 
-int test_pick_closest_line_rule(void) {
-  board g = new_game();
-
+TEST(test_pick_closest_line_rule, "Pick,Smoke") {
   // Scénario : SOUTH a des pièces sur ligne 0 et ligne 1.
-  // Pour simuler cela, on fait un setup complet, puis on avance une pièce.
-  helper_setup_game(g); // Tout le monde est sur sa ligne de départ
-
-  // Déplacer une pièce de SOUTH vers la ligne 1
-  pick_piece(g, SOUTH_P, 0, 0); // Disons pièce taille 1
-  move_piece(g, NORTH);         // Arrive en (1,0)
-  // Fin du tour SOUTH, tour NORTH (on passe son tour ou on joue un coup bidon pour revenir à SOUTH)
-  pick_piece(g, NORTH_P, 5, 0);
-  move_piece(g, SOUTH);
+  // Pour simuler cela, on fait un setup complet, puis on avance une pièce :
+  // SOUTH (0,0) [Taille 1] arrive en (1,0), puis NORTH joue (5,0) pour revenir à SOUTH.
+  board g = snapshot_take("opening", helper_opening);
 
   // RETOUR À SOUTH
   // État : SOUTH a une pièce en (1,0) et d'autres en (0,x).
@@ -144,22 +214,14 @@ int test_pick_closest_line_rule(void) {
 
 /* --- TESTS DE MOUVEMENT AVANCÉ (Rebond) --- */
 
-int test_movement_bounce(void) {
-  board g = new_game();
-  helper_setup_game(g);
-
+TEST(test_movement_bounce, "Move") {
   // On manipule pour créer une situation de rebond.
   // SOUTH (0,2) est taille 2. SOUTH (0,3) est taille 2.
   // On veut amener une pièce taille 1 (0,0) sur une case occupée.
 
   // Pour simplifier le test sans jouer 50 tours, on assume que la fonction move gère la logique.
-  // SOUTH joue (0,0) [Taille 1] -> Va en (1,0).
-  pick_piece(g, SOUTH_P, 0, 0);
-  move_piece(g, NORTH);
-
-  // NORTH joue
-  pick_piece(g, NORTH_P, 5, 0);
-  move_piece(g, SOUTH);
+  // SOUTH a joué (0,0) [Taille 1] -> (1,0), puis NORTH (5,0) -> (4,0).
+  board g = snapshot_take("opening", helper_opening);
 
   // SOUTH joue une autre pièce pour préparer le terrain : (0,2) [Taille 2] va en (2,2)
   pick_piece(g, SOUTH_P, 0, 2);
@@ -188,12 +250,11 @@ int test_movement_bounce(void) {
 
 /* --- TESTS DU COUP SPÉCIAL (SWAP) --- */
 
-int test_swap_logic(void) {
+TEST(test_swap_logic, "Swap") {
   /* Note: Ce test est théorique car il nécessite d'avoir une pièce sur une autre.
      On va vérifier les codes d'erreur hors situation valide.
   */
-  board g = new_game();
-  helper_setup_game(g);
+  board g = snapshot_take("setup", helper_setup_game);
 
   pick_piece(g, SOUTH_P, 4, 0);
 
@@ -205,8 +266,7 @@ int test_swap_logic(void) {
   // Si la case (1,0) est vide, swap retourne EMPTY ou FORBIDDEN car pas de collision.
 
   destroy_game(g);
-  g = new_game();
-  helper_setup_game(g);
+  g = snapshot_take("setup", helper_setup_game);
 
   pick_piece(g, SOUTH_P, 0, 0);
   move_piece(g, EAST); // Fin du mouvement pour une pièce de taille 1
@@ -219,9 +279,8 @@ int test_swap_logic(void) {
 
 /* --- TESTS DE VICTOIRE --- */
 
-int test_victory_edge_cases(void) {
-  board g = new_game();
-  helper_setup_game(g); // Setup valide
+TEST(test_victory_edge_cases, "Goal") {
+  board g = snapshot_take("setup", helper_setup_game); // Setup valide
 
   // SOUTH Piece de Taille 1 en (0,0).
   pick_piece(g, SOUTH_P, 0, 0);
@@ -245,7 +304,7 @@ int test_victory_edge_cases(void) {
 
 /* --- TESTS DE ROBUSTESSE --- */
 
-int test_robustness(void) {
+TEST(test_robustness, "Robustness,Smoke") {
   board g = new_game();
 
   // Appeler des fonctions de mouvement sans setup fini
@@ -275,7 +334,7 @@ int test_robustness(void) {
  * Elle atterrit sur une pièce de taille 3. (Mouvements restants devient 3).
  * Elle finit son mouvement dans le vide.
  */
-int test_complex_chain_bounce(void) {
+TEST(test_complex_chain_bounce, "Move,Bounce") {
   board g = new_game();
 
   // Ligne 1 (On utilise le setup de NORTH pour placer des obstacles ou des tremplins pour SOUTH ?)
@@ -369,7 +428,7 @@ void print_full_board_state(board g) {
  * Vérifie que la pièce éjectée est bien retirée, que la nouvelle prend sa place,
  * et que l'éjectée réapparait ailleurs.
  */
-int test_swap_integrity(void) {
+TEST(test_swap_integrity, "Swap") {
   board g = new_game();
 
   // Setup où (0,0) est SOUTH ONE et (0,1) est SOUTH TWO
@@ -426,9 +485,8 @@ int test_swap_integrity(void) {
  * Scénario : Règle de la ligne vide (Empty Line Rule)
  * Si la ligne la plus proche est vide, le joueur DOIT pouvoir jouer la ligne suivante.
  */
-int test_empty_line_selection(void) {
-  board g = new_game();
-  helper_setup_game(g);
+TEST(test_empty_line_selection, "Pick") {
+  board g = snapshot_take("setup", helper_setup_game);
 
   // Pour tester ça, il faut vider la ligne 0 de SOUTH.
   // C'est fastidieux à faire en jouant.
@@ -472,9 +530,8 @@ void helper_fill_setup(board g) {
 
 /* --- TESTS : LIMITES DU PLATEAU (WALLS) --- */
 
-int test_boundaries_corners(void) {
-  board g = new_game();
-  helper_fill_setup(g);
+TEST(test_boundaries_corners, "Move") {
+  board g = snapshot_take("fill_setup", helper_fill_setup);
 
   /* --- TEST 1: COIN SUD-OUEST (0,0) --- */
   // Pièce SOUTH en (0,0). Murs à l'Ouest et au Sud.
@@ -518,9 +575,8 @@ int test_boundaries_corners(void) {
 
 /* --- TESTS : OBSTACLES & PASSAGE A TRAVERS --- */
 
-int test_obstruction_jumping(void) {
-  board g = new_game();
-  helper_fill_setup(g);
+TEST(test_obstruction_jumping, "Move,Bounce") {
+  board g = snapshot_take("fill_setup", helper_fill_setup);
 
   /* Situation : SOUTH a une pièce en (0,0) [Taille 1] et en (0,1) [Taille 1].
      Il ne peut pas passer "à travers" (0,1) pour aller en (0,2) car il collisionne AVANT.
@@ -549,9 +605,8 @@ int test_obstruction_jumping(void) {
 
 /* --- TESTS : RÈGLE DU DEMI-TOUR (BACKTRACKING) --- */
 
-int test_backtracking_prevention(void) {
-  board g = new_game();
-  helper_fill_setup(g);
+TEST(test_backtracking_prevention, "Move") {
+  board g = snapshot_take("fill_setup", helper_fill_setup);
 
   // SOUTH (0,0) Taille 1.
   // On la déplace au NORD (vers 1,0). Case vide.
@@ -591,9 +646,8 @@ int test_backtracking_prevention(void) {
 
 /* --- TESTS : GOAL (EN-BUT) --- */
 
-int test_goal_entry_conditions(void) {
-  board g = new_game();
-  helper_fill_setup(g);
+TEST(test_goal_entry_conditions, "Goal") {
+  board g = snapshot_take("fill_setup", helper_fill_setup);
 
   // SOUTH Piece en (0,0).
   pick_piece(g, SOUTH_P, 0, 0);
@@ -624,9 +678,8 @@ int test_goal_entry_conditions(void) {
 
 /* --- TESTS : SÉLECTION DE LIGNE (PRIORITÉ) --- */
 
-int test_pick_priority_complex(void) {
-  board g = new_game();
-  helper_fill_setup(g);
+TEST(test_pick_priority_complex, "Pick") {
+  board g = snapshot_take("fill_setup", helper_fill_setup);
 
   // Avancer une pièce SOUTH de la ligne 0 vers la ligne 1.
   pick_piece(g, SOUTH_P, 0, 0);
@@ -650,9 +703,8 @@ int test_pick_priority_complex(void) {
 
 /* --- TESTS : DIRECTIONS EXHAUSTIVES --- */
 
-int test_all_directions_validity(void) {
-  board g = new_game();
-  helper_fill_setup(g);
+TEST(test_all_directions_validity, "Move") {
+  board g = snapshot_take("fill_setup", helper_fill_setup);
 
   // SOUTH (0,2) Taille 2. Au milieu de la ligne.
   pick_piece(g, SOUTH_P, 0, 2);
@@ -685,29 +737,49 @@ int test_all_directions_validity(void) {
   CATPASS("Compass: All Cardinal Directions Checked");
 }
 
-int main(void) {
-  int success = 1;
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-l] [-q] [-n name,...] [-t tag,...]\n", prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  int success = 1, list = 0;
+  const char *names = NULL, *tags = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-l") == 0)
+      list = 1;
+    else if (strcmp(argv[i], "-q") == 0)
+      quiet = 1;
+    else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      names = argv[++i];
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      tags = argv[++i];
+    else
+      usage(argv[0]);
+  }
+
+  if (list) {
+    for (int i = 0; i < nb_tests; i++)
+      if (selected(&registry[i], names, tags))
+        printf("%s\t%s\n", registry[i].name, registry[i].tags);
+    return 0;
+  }
 
   printf("%s=== BATTERIE DE TESTS AVANCÉS BOARD.C ===%s\n\n", BGBLUE, RESET);
 
-  success &= test_structure_basics();
-  success &= test_setup_limits();
-  success &= test_pick_closest_line_rule();
-  success &= test_movement_bounce();
-  success &= test_swap_logic();
-  success &= test_victory_edge_cases();
-  success &= test_robustness();
-
-  success &= test_complex_chain_bounce();
-  success &= test_swap_integrity();
-  success &= test_empty_line_selection();
-
-  success &= test_boundaries_corners();
-  success &= test_obstruction_jumping();
-  success &= test_backtracking_prevention();
-  success &= test_goal_entry_conditions();
-  success &= test_pick_priority_complex();
-  success &= test_all_directions_validity();
+  char failing[MAX_TESTS * 40] = "";
+  for (int i = 0; i < nb_tests; i++) {
+    if (!selected(&registry[i], names, tags))
+      continue;
+    trace_reset(registry[i].name);
+    if (!registry[i].fn()) {
+      success = 0;
+      if (failing[0])
+        strcat(failing, ",");
+      strcat(failing, registry[i].name);
+    }
+  }
 
   printf("\n%s==============================%s\n", BGBLUE, RESET);
   if (success)
@@ -718,8 +790,12 @@ int main(void) {
   printf("%s%d/%d tests passés.%s\n", bgyellow, total - failed, total, RESET);
   if (failed > 0)
     printf("%s%d tests échoués.%s\n", BGRED, failed, RESET);
+  if (failing[0])
+    printf("Catégories échouées : %s\n", failing);
 
   printf("\n%s===== FIN DES TESTS =====%s\n", BGBLUE, RESET);
 
+  snapshot_clear();
+
   return success ? 0 : 1;
 }
@@ -0,0 +1,409 @@
+#define _GNU_SOURCE
+#include "board.h"
+#include "turns.h"
+#include <math.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Coût par appel de chaque fonction de board.h, pour la DIMENSION de la
+ * compilation (make scaling compile un binaire par taille : -DDIMENSION=...).
+ *
+ * Les mesures portent sur un ensemble de positions obtenues par des parties
+ * aléatoires depuis le placement standard, pour que les pièces ne restent
+ * pas sur les lignes de départ (un parcours naïf du plateau y est rapide).
+ *   ./bench            tableau des coûts
+ *   ./bench -c         même chose, une ligne « nom ns » par fonction
+ *   ./bench -g bin...  lance chaque binaire avec -c et affiche la croissance
+ *                      du coût avec DIMENSION et l'exposant estimé
+ * Options des deux premières formes : -p épingle le processus sur un
+ * processeur ; -b fichier ajoute au tableau le rapport au coût du moteur de
+ * référence, lu dans une sortie de -c mesurée sur la même machine
+ * (make calibrate).
+ */
+
+#define POOL 64
+#define MIN_TIME_S 0.02
+#define TRIALS 5
+
+static board pool[POOL];    /* positions entre deux tours */
+static board picked[POOL];  /* mêmes positions, une pièce en main */
+static player to_move[POOL];
+static volatile long sink;
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* --- POSITIONS --- */
+
+static unsigned long rng = 88172645463325252UL;
+
+static unsigned long next_rand(void) {
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  return rng;
+}
+
+typedef struct pick_s {
+  board chosen;
+  int seen;
+} pick;
+
+/* Tirage uniforme d'un tour parmi ceux générés (échantillonnage par réservoir) */
+static int choose(board after, const turn *t, void *ctx) {
+  (void)t;
+  pick *p = ctx;
+  p->seen++;
+  if (next_rand() % p->seen != 0)
+    return 0;
+  if (p->chosen)
+    destroy_game(p->chosen);
+  p->chosen = after;
+  return 1;
+}
+
+static board standard_setup(void) {
+  board g = new_game();
+  for (int c = 0; c < DIMENSION; c++)
+    if (standard_piece(c) != NONE) {
+      place_piece(g, standard_piece(c), SOUTH_P, c);
+      place_piece(g, standard_piece(c), NORTH_P, c);
+    }
+  return g;
+}
+
+static void build_pool(void) {
+  board g = standard_setup();
+  player p = SOUTH_P;
+  for (int i = 0; i < POOL;) {
+    /* quelques tours entre deux positions retenues */
+    int turns = 1 + next_rand() % DIMENSION;
+    for (int k = 0; k < turns && get_winner(g) == NO_PLAYER; k++) {
+      pick pk = {NULL, 0};
+      gen_turns(g, p, choose, &pk);
+      if (pk.chosen == NULL)
+        break;
+      destroy_game(g);
+      g = pk.chosen;
+      p = next_player(p);
+    }
+    if (get_winner(g) != NO_PLAYER || (p == SOUTH_P ? southmost_occupied_line(g) : northmost_occupied_line(g)) < 0) {
+      destroy_game(g);
+      g = standard_setup();
+      p = SOUTH_P;
+      continue;
+    }
+    pool[i] = copy_game(g);
+    to_move[i] = p;
+    picked[i] = copy_game(g);
+    int line = p == SOUTH_P ? southmost_occupied_line(g) : northmost_occupied_line(g);
+    for (int c = 0; c < DIMENSION; c++)
+      if (pick_piece(picked[i], p, line, c) == OK)
+        break;
+    i++;
+  }
+  destroy_game(g);
+}
+
+/* --- MESURES --- */
+
+/* Chaque mesure parcourt l'ensemble des positions et retourne le nombre d'appels */
+
+static long bench_size(void) {
+  long s = 0;
+  for (int i = 0; i < POOL; i++)
+    for (int l = 0; l < DIMENSION; l++)
+      for (int c = 0; c < DIMENSION; c++)
+        s += get_piece_size(pool[i], l, c);
+  sink = s;
+  return (long)POOL * DIMENSION * DIMENSION;
+}
+
+static long bench_southmost(void) {
+  long s = 0;
+  for (int i = 0; i < POOL; i++)
+    s += southmost_occupied_line(pool[i]);
+  sink = s;
+  return POOL;
+}
+
+static long bench_northmost(void) {
+  long s = 0;
+  for (int i = 0; i < POOL; i++)
+    s += northmost_occupied_line(pool[i]);
+  sink = s;
+  return POOL;
+}
+
+static long bench_winner(void) {
+  long s = 0;
+  for (int i = 0; i < POOL; i++)
+    s += get_winner(pool[i]);
+  sink = s;
+  return POOL;
+}
+
+static long bench_available(void) {
+  long s = 0;
+  for (int i = 0; i < POOL; i++)
+    for (size z = ONE; z <= THREE; z++)
+      s += nb_pieces_available(pool[i], z, to_move[i]);
+  sink = s;
+  return POOL * NB_SIZE;
+}
+
+static long bench_copy(void) {
+  for (int i = 0; i < POOL; i++)
+    destroy_game(copy_game(pool[i]));
+  return POOL;
+}
+
+static long bench_setup(void) {
+  board g = standard_setup();
+  destroy_game(g);
+  return 1;
+}
+
+static long bench_pick(void) {
+  long n = 0;
+  for (int i = 0; i < POOL; i++) {
+    int line = to_move[i] == SOUTH_P ? southmost_occupied_line(pool[i]) : northmost_occupied_line(pool[i]);
+    for (int c = 0; c < DIMENSION; c++)
+      if (get_piece_size(pool[i], line, c) != NONE) {
+        pick_piece(pool[i], to_move[i], line, c);
+        cancel_movement(pool[i]);
+        n++;
+        break;
+      }
+  }
+  return n;
+}
+
+static long bench_possible(void) {
+  long s = 0;
+  for (int i = 0; i < POOL; i++)
+    for (direction d = GOAL; d <= WEST; d++)
+      s += is_move_possible(picked[i], d);
+  sink = s;
+  return POOL * 5;
+}
+
+static long bench_move(void) {
+  long n = 0;
+  for (int i = 0; i < POOL; i++)
+    for (direction d = SOUTH; d <= WEST; d++)
+      if (move_piece(picked[i], d) == OK) {
+        /* un seul pas en main : la pièce ne s'est pas posée, cancel_step le défait */
+        if (picked_piece_owner(picked[i]) == NO_PLAYER)
+          continue;
+        cancel_step(picked[i]);
+        n++;
+      }
+  return n;
+}
+
+static int count_turn(board after, const turn *t, void *ctx) {
+  (void)after;
+  (void)t;
+  (*(long *)ctx)++;
+  return 0;
+}
+
+static long bench_turns(void) {
+  long n = 0;
+  for (int i = 0; i < POOL; i++)
+    gen_turns(pool[i], to_move[i], count_turn, &n);
+  sink = n;
+  return POOL;
+}
+
+typedef struct measure_s {
+  const char *name;
+  const char *unit;
+  long (*fn)(void);
+} measure;
+
+static const measure measures[] = {
+    {"get_piece_size", "appel", bench_size},
+    {"southmost_occupied_line", "appel", bench_southmost},
+    {"northmost_occupied_line", "appel", bench_northmost},
+    {"get_winner", "appel", bench_winner},
+    {"nb_pieces_available", "appel", bench_available},
+    {"copy_game+destroy_game", "paire", bench_copy},
+    {"pick_piece+cancel_movement", "paire", bench_pick},
+    {"is_move_possible", "appel", bench_possible},
+    {"move_piece+cancel_step", "paire", bench_move},
+    {"new_game+placement+destroy", "partie", bench_setup},
+    {"gen_turns (tous les tours)", "position", bench_turns},
+};
+
+#define NB_MEASURES ((int)(sizeof(measures) / sizeof(measures[0])))
+
+/* Répète la mesure jusqu'à MIN_TIME_S, TRIALS fois ; retourne le meilleur
+   essai en ns par appel (les interruptions et la charge ne font que ralentir) */
+static double run_measure(const measure *m) {
+  double best = 0;
+  for (int t = 0; t < TRIALS; t++) {
+    long calls = 0;
+    double start = now_s(), elapsed;
+    do {
+      calls += m->fn();
+      elapsed = now_s() - start;
+    } while (elapsed < MIN_TIME_S);
+    double ns = calls ? elapsed * 1e9 / calls : 0;
+    if (t == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+/* --- CROISSANCE --- */
+
+#define MAX_SIZES 8
+
+typedef struct series_s {
+  int dimension;
+  double ns[NB_MEASURES];
+} series;
+
+/* Lit une sortie de -c ; dimension reste à 0 si elle n'y est pas */
+static void parse_series(FILE *f, series *s) {
+  char line[256];
+  s->dimension = 0;
+  for (int m = 0; m < NB_MEASURES; m++)
+    s->ns[m] = -1;
+  while (fgets(line, sizeof(line), f)) {
+    char *tab = strchr(line, '\t');
+    if (tab == NULL)
+      continue;
+    *tab = '\0';
+    if (strcmp(line, "DIMENSION") == 0)
+      s->dimension = atoi(tab + 1);
+    for (int m = 0; m < NB_MEASURES; m++)
+      if (strcmp(line, measures[m].name) == 0)
+        s->ns[m] = atof(tab + 1);
+  }
+}
+
+static int read_series(const char *bin, series *s) {
+  char cmd[512];
+  snprintf(cmd, sizeof(cmd), "%s -c", bin);
+  FILE *f = popen(cmd, "r");
+  if (f == NULL)
+    return -1;
+  parse_series(f, s);
+  int status = pclose(f);
+  return status == 0 && s->dimension > 0 ? 0 : -1;
+}
+
+static int growth(int nb, char **bins) {
+  series all[MAX_SIZES];
+  if (nb > MAX_SIZES)
+    nb = MAX_SIZES;
+  for (int i = 0; i < nb; i++)
+    if (read_series(bins[i], &all[i]) < 0) {
+      fprintf(stderr, "%s: mesure impossible\n", bins[i]);
+      return 2;
+    }
+
+  printf("%s=== CROISSANCE DU COÛT AVEC DIMENSION (ns) ===%s\n\n", BGBLUE, RESET);
+  printf("%-30s", "fonction");
+  for (int i = 0; i < nb; i++) {
+    char head[16];
+    snprintf(head, sizeof(head), "D=%d", all[i].dimension);
+    printf(" %10s", head);
+  }
+  printf("  %s\n", "exposant");
+  for (int m = 0; m < NB_MEASURES; m++) {
+    printf("%-30s", measures[m].name);
+    for (int i = 0; i < nb; i++)
+      printf(" %10.1f", all[i].ns[m]);
+    /* coût ~ D^k entre la plus petite et la plus grande taille */
+    double k = 0;
+    if (nb > 1 && all[0].ns[m] > 0 && all[nb - 1].ns[m] > 0)
+      k = log(all[nb - 1].ns[m] / all[0].ns[m]) / log((double)all[nb - 1].dimension / all[0].dimension);
+    printf("  %s%5.2f%s\n", k < 0.5 ? GREEN : k < 1.5 ? BLUE : RED, k, RESET);
+  }
+  printf("\n%sExposant k : coût proportionnel à DIMENSION^k (0 constant, 1 une ligne, 2 tout le plateau).%s\n",
+         bgyellow, RESET);
+  return 0;
+}
+
+/* Épingle le processus sur un processeur */
+static void pin_cpu(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) < 0)
+    perror("sched_setaffinity");
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-c] [-p cpu] [-b reference.txt] | -g bench_binary...\n", prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  int csv = 0;
+  series ref = {0, {0}};
+  if (argc > 1 && strcmp(argv[1], "-g") == 0) {
+    if (argc < 3)
+      usage(argv[0]);
+    return growth(argc - 2, argv + 2);
+  }
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-c") == 0)
+      csv = 1;
+    else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+      pin_cpu(atoi(argv[++i]));
+    else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      FILE *f = fopen(argv[++i], "r");
+      if (f == NULL) {
+        perror(argv[i]);
+        return 2;
+      }
+      parse_series(f, &ref);
+      fclose(f);
+    } else
+      usage(argv[0]);
+  }
+  /* une référence d'une autre taille de plateau ne se compare pas */
+  if (ref.dimension != DIMENSION)
+    ref.dimension = 0;
+
+  build_pool();
+  if (csv)
+    printf("DIMENSION\t%d\n", DIMENSION);
+  else
+    printf("%s=== COÛT PAR APPEL, DIMENSION %d ===%s\n\n", BGBLUE, DIMENSION, RESET);
+  for (int m = 0; m < NB_MEASURES; m++) {
+    double ns = run_measure(&measures[m]);
+    if (csv)
+      printf("%s\t%.2f\n", measures[m].name, ns);
+    else if (ref.dimension && ref.ns[m] > 0) {
+      double ratio = ns / ref.ns[m];
+      printf("%-30s %10.1f ns/%-8s %s%6.2f × réf.%s\n", measures[m].name, ns, measures[m].unit,
+             ratio < 1.5 ? GREEN : ratio < 4 ? BLUE : RED, ratio, RESET);
+    } else
+      printf("%-30s %10.1f ns/%s\n", measures[m].name, ns, measures[m].unit);
+  }
+  for (int i = 0; i < POOL; i++) {
+    destroy_game(pool[i]);
+    destroy_game(picked[i]);
+  }
+  return 0;
+}
@@ -81,7 +81,9 @@
  * In the following, all indices are given from 0 to ::DIMENSION - 1.
  * Small line numbers correspond to the south.
  */
+#ifndef DIMENSION
 #define DIMENSION 6
+#endif
 
 /**
  * @brief Pointer to the structure that holds the game. 
@@ -152,9 +154,9 @@ player next_player(player current_player);
 
 /**
  * @brief number of pieces of each size on each player's line at the beginning.
- * Usually, this value is 2.
+ * Usually, this value is 2 (the starting line is full on a 6 by 6 board).
  */
-#define NB_INITIAL_PIECES 2
+#define NB_INITIAL_PIECES (DIMENSION / NB_SIZE)
 
 /**
  * @brief return codes give semantics to the values returned by functions.
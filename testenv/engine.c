@@ -0,0 +1,166 @@
+#define _DEFAULT_SOURCE
+#include "engine.h"
+#include <dlfcn.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+static const engine *current = NULL;
+
+/* Forme recommandée par dlsym(3) pour obtenir un pointeur de fonction */
+static int resolve(engine *e, void **slot, const char *name) {
+  *slot = dlsym(e->handle, name);
+  if (*slot == NULL) {
+    fprintf(stderr, "%s: fonction %s absente\n", e->path, name);
+    return 0;
+  }
+  return 1;
+}
+
+#define RESOLVE(fn) ok &= resolve(e, (void **)&e->fn, #fn)
+
+int engine_load(engine *e, const char *path) {
+  memset(e, 0, sizeof(*e));
+  e->path = path;
+  /* Sans '/', dlopen cherche dans les répertoires système et non dans le
+   * répertoire courant : "board.so" doit devenir "./board.so". */
+  char local[PATH_MAX];
+  if (strchr(path, '/') == NULL) {
+    snprintf(local, sizeof(local), "./%s", path);
+    path = local;
+  }
+  e->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  if (e->handle == NULL) {
+    fprintf(stderr, "%s\n", dlerror());
+    return -1;
+  }
+  int ok = 1;
+  RESOLVE(next_player);
+  RESOLVE(new_game);
+  RESOLVE(copy_game);
+  RESOLVE(destroy_game);
+  RESOLVE(get_piece_size);
+  RESOLVE(get_winner);
+  RESOLVE(southmost_occupied_line);
+  RESOLVE(northmost_occupied_line);
+  RESOLVE(picked_piece_owner);
+  RESOLVE(picked_piece_size);
+  RESOLVE(picked_piece_line);
+  RESOLVE(picked_piece_column);
+  RESOLVE(movement_left);
+  RESOLVE(nb_pieces_available);
+  RESOLVE(place_piece);
+  RESOLVE(pick_piece);
+  RESOLVE(is_move_possible);
+  RESOLVE(move_piece);
+  RESOLVE(swap_piece);
+  RESOLVE(cancel_movement);
+  RESOLVE(cancel_step);
+  if (!ok) {
+    engine_unload(e);
+    return -1;
+  }
+  return 0;
+}
+
+void engine_unload(engine *e) {
+  if (current == e)
+    current = NULL;
+  if (e->handle)
+    dlclose(e->handle);
+  e->handle = NULL;
+}
+
+void engine_use(const engine *e) {
+  current = e;
+}
+
+const engine *engine_current(void) {
+  return current;
+}
+
+/* --- FONCTIONS DE board.h, RENVOYÉES AU MOTEUR CHOISI --- */
+
+player next_player(player current_player) {
+  return current->next_player(current_player);
+}
+
+board new_game(void) {
+  return current->new_game();
+}
+
+board copy_game(board original_game) {
+  return current->copy_game(original_game);
+}
+
+void destroy_game(board game) {
+  current->destroy_game(game);
+}
+
+size get_piece_size(board game, int line, int column) {
+  return current->get_piece_size(game, line, column);
+}
+
+player get_winner(board game) {
+  return current->get_winner(game);
+}
+
+int southmost_occupied_line(board game) {
+  return current->southmost_occupied_line(game);
+}
+
+int northmost_occupied_line(board game) {
+  return current->northmost_occupied_line(game);
+}
+
+player picked_piece_owner(board game) {
+  return current->picked_piece_owner(game);
+}
+
+size picked_piece_size(board game) {
+  return current->picked_piece_size(game);
+}
+
+int picked_piece_line(board game) {
+  return current->picked_piece_line(game);
+}
+
+int picked_piece_column(board game) {
+  return current->picked_piece_column(game);
+}
+
+int movement_left(board game) {
+  return current->movement_left(game);
+}
+
+int nb_pieces_available(board game, size piece, player player) {
+  return current->nb_pieces_available(game, piece, player);
+}
+
+return_code place_piece(board game, size piece, player player, int column) {
+  return current->place_piece(game, piece, player, column);
+}
+
+return_code pick_piece(board game, player current_player, int line, int column) {
+  return current->pick_piece(game, current_player, line, column);
+}
+
+bool is_move_possible(board game, direction direction) {
+  return current->is_move_possible(game, direction);
+}
+
+return_code move_piece(board game, direction direction) {
+  return current->move_piece(game, direction);
+}
+
+return_code swap_piece(board game, int target_line, int target_column) {
+  return current->swap_piece(game, target_line, target_column);
+}
+
+return_code cancel_movement(board game) {
+  return current->cancel_movement(game);
+}
+
+return_code cancel_step(board game) {
+  return current->cancel_step(game);
+}
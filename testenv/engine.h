@@ -0,0 +1,68 @@
+#ifndef _ENGINE_H_
+#define _ENGINE_H_
+
+#include "board.h"
+
+/**
+ * \file engine.h
+ *
+ * \brief Chargement de moteurs compilés en bibliothèques partagées.
+ *
+ * Chaque board.c est compilé à part en .so (-fPIC -shared -Wl,-Bsymbolic)
+ * et chargé avec RTLD_LOCAL : plusieurs moteurs cohabitent dans un même
+ * programme sans que leurs symboles ne se mélangent. Les fonctions de
+ * board.h, définies par engine.c, appellent le moteur choisi par
+ * ::engine_use ; turns.c et search.c s'en servent donc sans modification.
+ */
+
+/**
+ * @brief table des fonctions de board.h d'un moteur chargé.
+ */
+typedef struct engine_s {
+  const char *path;  /**< fichier .so chargé */
+  void *handle;      /**< retour de dlopen */
+  player (*next_player)(player current_player);
+  board (*new_game)(void);
+  board (*copy_game)(board original_game);
+  void (*destroy_game)(board game);
+  size (*get_piece_size)(board game, int line, int column);
+  player (*get_winner)(board game);
+  int (*southmost_occupied_line)(board game);
+  int (*northmost_occupied_line)(board game);
+  player (*picked_piece_owner)(board game);
+  size (*picked_piece_size)(board game);
+  int (*picked_piece_line)(board game);
+  int (*picked_piece_column)(board game);
+  int (*movement_left)(board game);
+  int (*nb_pieces_available)(board game, size piece, player player);
+  return_code (*place_piece)(board game, size piece, player player, int column);
+  return_code (*pick_piece)(board game, player current_player, int line, int column);
+  bool (*is_move_possible)(board game, direction direction);
+  return_code (*move_piece)(board game, direction direction);
+  return_code (*swap_piece)(board game, int target_line, int target_column);
+  return_code (*cancel_movement)(board game);
+  return_code (*cancel_step)(board game);
+} engine;
+
+/**
+ * @brief charge un moteur et résout toutes les fonctions de board.h.
+ * @return 0 en cas de succès, -1 sinon (message sur stderr).
+ */
+int engine_load(engine *e, const char *path);
+
+/**
+ * @brief décharge un moteur.
+ */
+void engine_unload(engine *e);
+
+/**
+ * @brief choisit le moteur appelé par les fonctions de board.h.
+ */
+void engine_use(const engine *e);
+
+/**
+ * @brief moteur actuellement choisi, NULL si aucun.
+ */
+const engine *engine_current(void);
+
+#endif /*_ENGINE_H_*/
@@ -0,0 +1,373 @@
+#define _DEFAULT_SOURCE
+#include "board.h"
+#include "turns.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Exploration en largeur des positions atteignables par l'API board.h.
+ *
+ * Profondeur 0 : les positions après placement (une seule, ou toutes avec -a).
+ * Chaque niveau joue tous les tours complets du joueur au trait (SOUTH_P
+ * commence). Les positions sont identifiées par leur clé canonique (turns.h)
+ * et dédoublonnées dans un ensemble partitionné en sous-tables verrouillées.
+ * Les positions gagnantes sont comptées mais pas développées.
+ *
+ * Le moteur lié doit supporter des parties distinctes dans des threads
+ * distincts (pas d'état global) ; sinon utiliser -j 1.
+ *
+ * Fichier de sortie (-o), entiers petit-boutistes :
+ *   "GEXP" u32 version, u32 DIMENSION, u32 KEY_BYTES
+ *   par profondeur : u32 profondeur, u64 positions, u64 gains SOUTH_P,
+ *                    u64 gains NORTH_P, puis positions × KEY_BYTES octets
+ */
+
+#define NB_SHARDS 256
+
+/* --- ENSEMBLE DE CLÉS PARTITIONNÉ --- */
+
+typedef struct shard_s {
+  pthread_mutex_t lock;
+  board_key *keys;
+  unsigned char *used;
+  size_t cap, count;
+} shard;
+
+static shard shards[NB_SHARDS];
+
+static void shard_grow(shard *s) {
+  size_t ncap = s->cap ? s->cap * 2 : 1024;
+  board_key *keys = malloc(ncap * sizeof(board_key));
+  unsigned char *used = calloc(ncap, 1);
+  for (size_t i = 0; i < s->cap; i++) {
+    if (!s->used[i])
+      continue;
+    size_t j = (key_hash(&s->keys[i]) >> 8) & (ncap - 1);
+    while (used[j])
+      j = (j + 1) & (ncap - 1);
+    keys[j] = s->keys[i];
+    used[j] = 1;
+  }
+  free(s->keys);
+  free(s->used);
+  s->keys = keys;
+  s->used = used;
+  s->cap = ncap;
+}
+
+/* Retourne 1 si la clé est nouvelle (et l'insère) */
+static int set_insert(const board_key *k) {
+  uint64_t h = key_hash(k);
+  shard *s = &shards[h & (NB_SHARDS - 1)];
+  pthread_mutex_lock(&s->lock);
+  if (2 * (s->count + 1) > s->cap)
+    shard_grow(s);
+  size_t j = (h >> 8) & (s->cap - 1);
+  while (s->used[j]) {
+    if (memcmp(&s->keys[j], k, sizeof(*k)) == 0) {
+      pthread_mutex_unlock(&s->lock);
+      return 0;
+    }
+    j = (j + 1) & (s->cap - 1);
+  }
+  s->keys[j] = *k;
+  s->used[j] = 1;
+  s->count++;
+  pthread_mutex_unlock(&s->lock);
+  return 1;
+}
+
+/* --- NIVEAUX --- */
+
+typedef struct node_s {
+  board game;
+  board_key key;
+} node;
+
+typedef struct level_s {
+  node *nodes;
+  size_t count, cap;
+} level;
+
+static void level_push(level *lv, board g, const board_key *k) {
+  if (lv->count == lv->cap) {
+    lv->cap = lv->cap ? lv->cap * 2 : 1024;
+    lv->nodes = realloc(lv->nodes, lv->cap * sizeof(node));
+  }
+  lv->nodes[lv->count++] = (node){g, *k};
+}
+
+typedef struct worker_s {
+  pthread_t thread;
+  const level *from;
+  size_t begin, end;
+  player to_move;
+  level next;
+  level wins;
+  unsigned long wins_by[NB_PLAYERS + 1];
+  unsigned long turns;
+} worker;
+
+static size_t max_states = 500000;
+static size_t stored = 0;
+static pthread_mutex_t stored_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int on_turn(board after, const turn *t, void *ctx) {
+  (void)t;
+  worker *w = ctx;
+  w->turns++;
+  player winner = get_winner(after);
+  board_key k = make_key(after, next_player(w->to_move));
+  if (!set_insert(&k))
+    return 0;
+  if (winner != NO_PLAYER) {
+    w->wins_by[winner]++;
+    level_push(&w->wins, NULL, &k);
+    return 0;
+  }
+  pthread_mutex_lock(&stored_lock);
+  int room = stored < max_states;
+  stored += room;
+  pthread_mutex_unlock(&stored_lock);
+  if (!room) {
+    level_push(&w->next, NULL, &k);
+    return 0;
+  }
+  level_push(&w->next, after, &k);
+  return 1;
+}
+
+static void *expand(void *arg) {
+  worker *w = arg;
+  for (size_t i = w->begin; i < w->end; i++)
+    if (w->from->nodes[i].game != NULL)
+      gen_turns(w->from->nodes[i].game, w->to_move, on_turn, w);
+  return NULL;
+}
+
+/* --- POSITIONS DE DÉPART --- */
+
+static int nb_arrangements = 0;
+static size (*arrangements)[DIMENSION] = NULL;
+
+/* Toutes les lignes complètes : NB_INITIAL_PIECES pièces de chaque taille
+   (des cases vides en plus sur les plateaux de plus de 6 colonnes) */
+static void enumerate_full(int column, size line[DIMENSION], int counts[NB_SIZE + 1]) {
+  if (column == DIMENSION) {
+    arrangements = realloc(arrangements, (nb_arrangements + 1) * sizeof(*arrangements));
+    memcpy(arrangements[nb_arrangements++], line, sizeof(size) * DIMENSION);
+    return;
+  }
+  for (int s = NONE; s <= THREE; s++) {
+    if (s == NONE && counts[NONE] == DIMENSION - NB_SIZE * NB_INITIAL_PIECES)
+      continue;
+    if (s != NONE && counts[s] == NB_INITIAL_PIECES)
+      continue;
+    counts[s]++;
+    line[column] = s;
+    enumerate_full(column + 1, line, counts);
+    counts[s]--;
+  }
+}
+
+static board setup(const size south[DIMENSION], const size north[DIMENSION]) {
+  board g = new_game();
+  for (int c = 0; c < DIMENSION; c++) {
+    if (south[c] != NONE)
+      place_piece(g, south[c], SOUTH_P, c);
+    if (north[c] != NONE)
+      place_piece(g, north[c], NORTH_P, c);
+  }
+  return g;
+}
+
+/* --- SORTIE --- */
+
+static void put_u32(FILE *f, uint32_t v) {
+  for (int i = 0; i < 4; i++)
+    fputc((v >> (8 * i)) & 0xff, f);
+}
+
+static void put_u64(FILE *f, uint64_t v) {
+  for (int i = 0; i < 8; i++)
+    fputc((v >> (8 * i)) & 0xff, f);
+}
+
+static void put_key(FILE *f, const board_key *k) {
+  for (int i = 0; i < KEY_BYTES; i++)
+    fputc((k->w[i / 8] >> (8 * (i % 8))) & 0xff, f);
+}
+
+static void write_level(FILE *f, int depth, const level *lv, const level *wins, const unsigned long wins_by[]) {
+  put_u32(f, depth);
+  put_u64(f, lv->count + wins->count);
+  put_u64(f, wins_by[SOUTH_P]);
+  put_u64(f, wins_by[NORTH_P]);
+  for (size_t i = 0; i < lv->count; i++)
+    put_key(f, &lv->nodes[i].key);
+  for (size_t i = 0; i < wins->count; i++)
+    put_key(f, &wins->nodes[i].key);
+}
+
+static double now_s(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-a] [-d depth] [-j threads] [-m max_states] [-o file]\n", prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  int all_setups = 0, max_depth = 3, nb_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  const char *out_path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-a") == 0)
+      all_setups = 1;
+    else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+      max_depth = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      nb_threads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+      max_states = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      out_path = argv[++i];
+    else
+      usage(argv[0]);
+  }
+  if (nb_threads < 1)
+    nb_threads = 1;
+  for (int i = 0; i < NB_SHARDS; i++)
+    pthread_mutex_init(&shards[i].lock, NULL);
+
+  FILE *out = NULL;
+  if (out_path) {
+    out = fopen(out_path, "wb");
+    if (out == NULL) {
+      perror(out_path);
+      return 2;
+    }
+    fwrite("GEXP", 1, 4, out);
+    put_u32(out, 1);
+    put_u32(out, DIMENSION);
+    put_u32(out, KEY_BYTES);
+  }
+
+  level current = {0}, no_wins = {0};
+  if (all_setups) {
+    size line[DIMENSION];
+    int counts[NB_SIZE + 1] = {0};
+    enumerate_full(0, line, counts);
+    for (int s = 0; s < nb_arrangements; s++)
+      for (int n = 0; n < nb_arrangements; n++) {
+        board g = setup(arrangements[s], arrangements[n]);
+        board_key k = make_key(g, SOUTH_P);
+        set_insert(&k);
+        level_push(&current, g, &k);
+      }
+  } else {
+    /* Placement standard : 1 1 2 2 3 3 */
+    size line[DIMENSION];
+    for (int c = 0; c < DIMENSION; c++)
+      line[c] = standard_piece(c);
+    board g = setup(line, line);
+    board_key k = make_key(g, SOUTH_P);
+    set_insert(&k);
+    level_push(&current, g, &k);
+  }
+  stored = current.count;
+
+  printf("%s=== EXPLORATION (%d threads, %zu positions max) ===%s\n\n", BGBLUE, nb_threads, max_states, RESET);
+  printf("%-10s %14s %14s %12s %12s %10s\n", "profondeur", "positions", "tours joués", "gains SUD", "gains NORD", "temps (s)");
+  unsigned long zero[NB_PLAYERS + 1] = {0};
+  printf("%-10d %14zu %14s %12d %12d %10s\n", 0, current.count, "-", 0, 0, "-");
+  if (out)
+    write_level(out, 0, &current, &no_wins, zero);
+
+  worker *workers = calloc(nb_threads, sizeof(worker));
+  player to_move = SOUTH_P;
+  int truncated = 0;
+  double start = now_s();
+  for (int depth = 1; depth <= max_depth && current.count > 0; depth++) {
+    double t0 = now_s();
+    size_t chunk = (current.count + nb_threads - 1) / nb_threads;
+    for (int i = 0; i < nb_threads; i++) {
+      worker *w = &workers[i];
+      memset(w, 0, sizeof(*w));
+      w->from = &current;
+      w->begin = i * chunk < current.count ? i * chunk : current.count;
+      w->end = w->begin + chunk < current.count ? w->begin + chunk : current.count;
+      w->to_move = to_move;
+      pthread_create(&w->thread, NULL, expand, w);
+    }
+
+    level next = {0}, wins = {0};
+    unsigned long wins_by[NB_PLAYERS + 1] = {0}, turns = 0;
+    for (int i = 0; i < nb_threads; i++) {
+      worker *w = &workers[i];
+      pthread_join(w->thread, NULL);
+      for (size_t j = 0; j < w->next.count; j++)
+        level_push(&next, w->next.nodes[j].game, &w->next.nodes[j].key);
+      for (size_t j = 0; j < w->wins.count; j++)
+        level_push(&wins, NULL, &w->wins.nodes[j].key);
+      for (int p = 0; p <= NB_PLAYERS; p++)
+        wins_by[p] += w->wins_by[p];
+      turns += w->turns;
+      free(w->next.nodes);
+      free(w->wins.nodes);
+    }
+
+    for (size_t i = 0; i < current.count; i++)
+      if (current.nodes[i].game != NULL)
+        destroy_game(current.nodes[i].game);
+    free(current.nodes);
+    stored = 0;
+    for (size_t i = 0; i < next.count; i++)
+      stored += next.nodes[i].game != NULL;
+    if (stored < next.count)
+      truncated = 1;
+
+    printf("%-10d %14zu %14lu %12lu %12lu %10.2f\n", depth, next.count + wins.count, turns,
+           wins_by[SOUTH_P], wins_by[NORTH_P], now_s() - t0);
+    fflush(stdout);
+    if (out)
+      write_level(out, depth, &next, &wins, wins_by);
+    free(wins.nodes);
+    current = next;
+    to_move = next_player(to_move);
+  }
+
+  for (size_t i = 0; i < current.count; i++)
+    if (current.nodes[i].game != NULL)
+      destroy_game(current.nodes[i].game);
+  free(current.nodes);
+  free(workers);
+
+  size_t distinct = 0;
+  for (int i = 0; i < NB_SHARDS; i++)
+    distinct += shards[i].count;
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  printf("\n%s%zu positions distinctes en %.2f s, mémoire max %ld Mo.%s\n", bgyellow, distinct,
+         now_s() - start, ru.ru_maxrss / 1024, RESET);
+  if (truncated)
+    printf("%sLimite de %zu positions atteinte : certains niveaux ne sont pas développés en entier.%s\n",
+           RED, max_states, RESET);
+  if (out)
+    fclose(out);
+  return 0;
+}
@@ -0,0 +1,870 @@
+#define _DEFAULT_SOURCE
+#include "board.h"
+#include "record.h"
+#include "snapshot.h"
+#include "symmetry.h"
+#include "tracer.h"
+#include "turns.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGRED "\033[101m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Fuzzing en processus de l'API board.h.
+ *
+ * Une entrée (suite d'octets) est traduite en suite d'appels à l'API sur
+ * quelques parties à la fois : création, copie, destruction, placement,
+ * prise, déplacement, échange, annulations et consultations, avec des
+ * arguments quelconques, invalides compris. Chaque exécution se termine
+ * par la destruction des parties restantes : pas de nouveau processus entre
+ * deux entrées. Un résultat hors des valeurs permises par board.h est
+ * traité comme un plantage.
+ *
+ * Les suites qui trouvent une nouvelle couverture, et une sur 16 tirée au
+ * hasard, sont rejouées dans les trois variantes symétriques (symmetry.h),
+ * à travers les enveloppes de recorder.c : miroir est-ouest, retournement
+ * nord-sud et les deux. Un moteur correct y donne les mêmes résultats ;
+ * une différence est traitée comme un plantage. Avec -y (FUZZ_SYMMETRY=1
+ * sous libFuzzer), toutes les suites le sont, et les plateaux (lus par
+ * get_piece_size avant chaque destruction) sont aussi comparés : cinq fois
+ * plus lent. Une entrée rejouée en détail l'est dans les quatre variantes,
+ * plateaux compris. Pour rejouer la variante fautive, BOARD_RECORD=fichier ./fuzz
+ * entrée enregistre les appels tels que le moteur les a reçus, variantes
+ * comprises.
+ *
+ * Une création peut partir du placement standard : la partie est alors une
+ * copie de la position gardée par snapshot.h, sans rejouer les placements à
+ * chaque exécution. La suite d'appels décodée contient ces placements ;
+ * sous -o, ils sont joués au lieu de la copie.
+ *
+ * LLVMFuzzerTestOneInput s'utilise tel quel avec libFuzzer (make libfuzz,
+ * clang). Sans libFuzzer, une boucle de mutation intégrée est guidée par la
+ * couverture du moteur seul, compilé avec -fsanitize-coverage=trace-pc
+ * (gcc), le tout sous ASan et UBSan (make fuzz).
+ *   ./fuzz [-n exécutions] [-T secondes] [-t timeout_s] [-s graine] [-j processus]
+ *          [-d corpus] [-a répertoire_des_plantages] [-y]
+ *   ./fuzz [-o sortie.rec] entrée...   rejoue des entrées en détaillant les appels
+ * Les entrées qui plantent sont écrites dans crash-<empreinte> (timeout-<...>
+ * pour les boucles infinies) ; -o les convertit en enregistrement pour
+ * replay et minimize, avec les résultats observés pendant l'exécution
+ * (jusqu'à l'appel qui plante compris) de la suite sans symétrie.
+ */
+
+#define NB_SLOTS 4
+#define MAX_INPUT_LEN 512
+/* placements du placement standard, pour les deux joueurs */
+#define SETUP_ENTRIES (2 * NB_SIZE * NB_INITIAL_PIECES)
+/* une création (2 octets) peut donner une destruction, la création et le placement */
+#define MAX_ENTRIES (MAX_INPUT_LEN / 2 * (SETUP_ENTRIES + 2) + NB_SLOTS)
+
+/* --- DÉCODAGE --- */
+
+/* Les appels qui modifient la partie sont plus fréquents que les consultations */
+static const int fuzz_ops[] = {
+    REC_NEW, REC_COPY, REC_DESTROY, CALL_PLACE, CALL_PLACE, CALL_PICK, CALL_PICK, CALL_MOVE, CALL_MOVE,
+    CALL_MOVE, CALL_SWAP, CALL_CANCEL_MOVEMENT, CALL_CANCEL_STEP, CALL_POSSIBLE, CALL_SIZE, CALL_WINNER,
+    CALL_SOUTHMOST, CALL_NORTHMOST, CALL_OWNER, CALL_HELD, CALL_LINE, CALL_COLUMN, CALL_LEFT, CALL_AVAILABLE,
+};
+
+#define NB_FUZZ_OPS ((int)(sizeof(fuzz_ops) / sizeof(fuzz_ops[0])))
+
+/* Un argument : le plus souvent autour du plateau, parfois une valeur extrême */
+static int decode_arg(uint8_t b) {
+  static const int extremes[16] = {-128, 127, -100, 100, -DIMENSION, DIMENSION, DIMENSION + 1, 2 * DIMENSION,
+                                   -3, -4, 5, 6, 7, 8, 9, 10};
+  return b < 0xF0 ? b % (DIMENSION + 4) - 2 : extremes[b & 15];
+}
+
+/*
+ * Chaque appel occupe un octet d'opération, un octet de parties (case visée,
+ * et case source pour copy_game) puis ses arguments. Les appels sur une case
+ * vide sont ignorés ; une création sur une case occupée détruit d'abord
+ * l'ancienne partie, et une création dont la case source est impaire est
+ * suivie du placement standard (marquée dans from_setup). Les numéros de
+ * partie sont attribués à la création, comme dans un enregistrement.
+ */
+static uint8_t from_setup[MAX_ENTRIES];
+
+static int decode(const uint8_t *data, size_t size, rec_entry *out) {
+  int slots[NB_SLOTS], next_id = 0, n = 0;
+  for (int s = 0; s < NB_SLOTS; s++)
+    slots[s] = -1;
+  size_t i = 0;
+  while (i + 2 <= size) {
+    int op = fuzz_ops[data[i] % NB_FUZZ_OPS];
+    int slot = data[i + 1] % NB_SLOTS, other = data[i + 1] / NB_SLOTS % NB_SLOTS;
+    i += 2;
+    int nb = rec_nb_args(op);
+    if (i + nb > size)
+      break;
+    rec_entry e = {op, slots[slot], {0}, 0};
+    for (int a = 0; a < nb; a++)
+      e.args[a] = decode_arg(data[i++]);
+    switch (op) {
+    case REC_NEW:
+      if (slots[slot] >= 0)
+        out[n++] = (rec_entry){REC_DESTROY, slots[slot], {0}, 0};
+      e.game = -1;
+      e.result = slots[slot] = next_id++;
+      from_setup[n] = other & 1;
+      out[n++] = e;
+      if (other & 1)
+        for (int c = 0; c < DIMENSION; c++)
+          if (standard_piece(c) != NONE) {
+            out[n++] = (rec_entry){CALL_PLACE, e.result, {standard_piece(c), SOUTH_P, c}, 0};
+            out[n++] = (rec_entry){CALL_PLACE, e.result, {standard_piece(c), NORTH_P, c}, 0};
+          }
+      continue;
+    case REC_COPY:
+      if (slots[other] < 0)
+        continue;
+      /* la source reste vivante pendant la copie, même si c'est la case visée */
+      e.game = slots[other];
+      e.result = next_id++;
+      out[n++] = e;
+      if (slots[slot] >= 0)
+        out[n++] = (rec_entry){REC_DESTROY, slots[slot], {0}, 0};
+      slots[slot] = e.result;
+      continue;
+    case REC_DESTROY:
+      if (slots[slot] < 0)
+        continue;
+      slots[slot] = -1;
+      break;
+    default:
+      if (slots[slot] < 0)
+        continue;
+    }
+    out[n++] = e;
+  }
+  for (int s = 0; s < NB_SLOTS; s++)
+    if (slots[s] >= 0)
+      out[n++] = (rec_entry){REC_DESTROY, slots[s], {0}, 0};
+  return n;
+}
+
+/* --- EXÉCUTION --- */
+
+static const uint8_t *current;  /* entrée en cours, sauvegardée en cas de plantage */
+static size_t current_len;
+static volatile unsigned long executions = 0;
+static int verbose = 0;
+/* -o : enregistrement des appels exécutés, avec leur résultat */
+static rec_writer *recording = NULL;
+static const rec_entry *recorded;
+static volatile int nb_started = 0;
+
+/* Valeurs de retour permises par board.h */
+static int in_spec(int op, int r) {
+  switch (op) {
+  case REC_NEW:
+  case REC_COPY:
+  case REC_DESTROY:
+    return r == 1;
+  case CALL_POSSIBLE:
+    return r == 0 || r == 1;
+  case CALL_SIZE:
+  case CALL_HELD:
+    return r >= NONE && r <= THREE;
+  case CALL_WINNER:
+  case CALL_OWNER:
+    return r >= NO_PLAYER && r <= NORTH_P;
+  case CALL_SOUTHMOST:
+  case CALL_NORTHMOST:
+  case CALL_LINE:
+  case CALL_COLUMN:
+    return r >= -1 && r < DIMENSION;
+  case CALL_LEFT:
+    return r >= -1 && r <= NB_SIZE;
+  case CALL_AVAILABLE:
+    return r >= -1 && r <= NB_INITIAL_PIECES;
+  default:
+    return r >= OK && r <= PARAM;
+  }
+}
+
+static void print_entry(int index, const rec_entry *e) {
+  printf("%5d  g%-3d %-16s", index, e->game, rec_op_name(e->op));
+  for (int i = 0; i < rec_nb_args(e->op); i++)
+    printf(" %d", e->args[i]);
+}
+
+/* Même suite d'appels que les entrées de placement produites par decode */
+static void standard_setup(board g) {
+  for (int c = 0; c < DIMENSION; c++)
+    if (standard_piece(c) != NONE) {
+      place_piece(g, standard_piece(c), SOUTH_P, c);
+      place_piece(g, standard_piece(c), NORTH_P, c);
+    }
+}
+
+/* Écrit les appels commencés, celui en cours compris (utilisable dans un gestionnaire de signal) */
+static void write_recording(void) {
+  if (recording == NULL)
+    return;
+  for (int i = 0; i < nb_started; i++)
+    rec_write(recording, &recorded[i]);
+  rec_flush(recording);
+  recording = NULL;
+}
+
+/* Variantes jouées pour chaque suite ; la première, sans symétrie, donne les résultats attendus */
+static const struct {
+  bool mirror, flip;
+  const char *setup_key; /* placement standard gardé, construit dans la variante */
+} variants[] = {
+    {false, false, "standard"},
+    {true, false, "standard miroir"},
+    {false, true, "standard retourné"},
+    {true, true, "standard miroir retourné"},
+};
+
+#define NB_VARIANTS ((int)(sizeof(variants) / sizeof(variants[0])))
+
+/* -y : toutes les entrées sont jouées dans chaque variante, plateaux
+ * compris ; sinon celles qui élargissent la couverture, et une sur
+ * SYMMETRY_SAMPLE, résultats seuls */
+static int symmetric = 0;
+#define SYMMETRY_SAMPLE 16
+
+static void divergence(int index, const rec_entry *e, const char *what, int got, int want) {
+  fflush(stdout);
+  fprintf(stderr, "%s ❌ divergence sous symétrie (%s) : appel %d, %s %s %d au lieu de %d%s\n", RED, sym_name(),
+          index, rec_op_name(e->op), what, got, want, RESET);
+  abort();
+}
+
+/* Plateaux des parties avant chaque destruction, dans la variante sans
+ * symétrie ; lus seulement avec -y et pour une entrée rejouée en détail */
+static signed char grids[MAX_ENTRIES][DIMENSION][DIMENSION];
+
+static void check_grid(int variant, int index, const rec_entry *e, board g) {
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++) {
+      int piece = get_piece_size(g, l, c);
+      if (variant == 0)
+        grids[index][l][c] = piece;
+      else if (piece != grids[index][l][c]) {
+        char what[64];
+        snprintf(what, sizeof(what), ": case %d %d du plateau ->", l, c);
+        divergence(index, e, what, piece, grids[index][l][c]);
+      }
+    }
+}
+
+/* Joue la suite dans une variante ; la première range les résultats des
+ * appels à l'API dans seq, pour -o et pour les variantes suivantes */
+static void execute_variant(rec_entry *seq, int n, int variant, bool boards) {
+  static board games[MAX_ENTRIES];
+  for (int i = 0; i < n; i++) {
+    rec_entry *e = &seq[i];
+    nb_started = i + 1;
+    if (verbose) {
+      print_entry(i, e);
+      fflush(stdout);
+    }
+    int r;
+    switch (e->op) {
+    case REC_NEW:
+      if (from_setup[i] && recording == NULL) {
+        /* les placements qui suivent sont remplacés par la copie */
+        r = (games[e->result] = snapshot_take(variants[variant].setup_key, standard_setup)) != NULL;
+        if (verbose)
+          printf(" (copie du placement standard, %d appels sautés)", SETUP_ENTRIES);
+        i += SETUP_ENTRIES;
+        break;
+      }
+      r = (games[e->result] = new_game()) != NULL;
+      break;
+    case REC_COPY:
+      r = (games[e->result] = copy_game(games[e->game])) != NULL;
+      break;
+    case REC_DESTROY:
+      if (boards && games[e->game] != NULL)
+        check_grid(variant, i, e, games[e->game]);
+      destroy_game(games[e->game]);
+      games[e->game] = NULL;
+      r = 1;
+      break;
+    default: {
+      step s = {e->op, e->args[0], e->args[1], e->args[2], 0, 0};
+      r = step_exec(games[e->game], &s, NULL);
+    }
+    }
+    if (verbose)
+      printf(" -> %d\n", r);
+    if (!in_spec(e->op, r)) {
+      fflush(stdout);
+      fprintf(stderr, "%s ❌ résultat hors spécification%s%s%s : appel %d, %s -> %d%s\n", RED,
+              sym_name() ? " sous symétrie (" : "", sym_name() ? sym_name() : "", sym_name() ? ")" : "", i,
+              rec_op_name(e->op), r, RESET);
+      abort();
+    }
+    /* appels à l'API : même résultat dans chaque variante */
+    if (e->op < NB_CALLS) {
+      if (variant == 0)
+        e->result = r;
+      else if (r != e->result)
+        divergence(i, e, "->", r, e->result);
+    }
+  }
+}
+
+/* Joue la suite sans symétrie, puis dans les autres variantes si nb_variants > 1 */
+static void execute(rec_entry *seq, int n, int nb_variants) {
+  for (int v = 0; v < nb_variants; v++) {
+    sym_set(variants[v].mirror, variants[v].flip);
+    if (verbose && v > 0)
+      printf("%s--- variante : %s ---%s\n", BLUE, sym_name(), RESET);
+    execute_variant(seq, n, v, nb_variants > 1 && (symmetric || verbose));
+    /* -o : seule la suite sans symétrie est enregistrée */
+    if (v == 0)
+      write_recording();
+  }
+  sym_set(false, false);
+}
+
+static void run_input(const uint8_t *data, size_t size, int nb_variants) {
+  static rec_entry seq[MAX_ENTRIES];
+  if (size > MAX_INPUT_LEN)
+    size = MAX_INPUT_LEN;
+  current = data;
+  current_len = size;
+  execute(seq, decode(data, size, seq), nb_variants);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+#ifdef FUZZ_LIBFUZZER
+  static int init = 0;
+  if (!init) {
+    const char *s = getenv("FUZZ_SYMMETRY");
+    symmetric = s != NULL && strcmp(s, "1") == 0;
+    trace_clock = 0;
+    init = 1;
+  }
+#endif
+  run_input(data, size, symmetric ? NB_VARIANTS : 1);
+  executions++;
+  return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+/* --- PLANTAGES --- */
+
+static uint64_t input_hash(const uint8_t *data, size_t len) {
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t i = 0; i < len; i++)
+    h = (h ^ data[i]) * 1099511628211ULL;
+  return h;
+}
+
+static const char *artifacts = ".";
+
+static void save_input(const char *prefix) {
+  uint64_t h = input_hash(current, current_len);
+  /* écriture sans stdio : peut être appelé depuis un gestionnaire de signal */
+  char name[4096];
+  size_t len = strlen(artifacts);
+  if (len + strlen(prefix) + 20 > sizeof(name))
+    len = 0;
+  memcpy(name, artifacts, len);
+  name[len++] = '/';
+  memcpy(name + len, prefix, strlen(prefix));
+  len += strlen(prefix);
+  name[len++] = '-';
+  for (int k = 60; k >= 0; k -= 4)
+    name[len++] = "0123456789abcdef"[(h >> k) & 15];
+  name[len] = '\0';
+  int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  int saved = fd >= 0 && write(fd, current, current_len) == (ssize_t)current_len;
+  if (fd >= 0)
+    close(fd);
+  const char *msg = saved ? "\nentrée sauvegardée dans " : "\nimpossible d'écrire ";
+  if (write(2, msg, strlen(msg)) > 0 && write(2, name, len) > 0)
+    (void)!write(2, "\n", 1);
+}
+
+/* --- COUVERTURE --- */
+
+/*
+ * Appelée par le moteur instrumenté (-fsanitize-coverage=trace-pc) à chaque
+ * bloc de base : compte les paires de blocs successifs, comme AFL.
+ */
+#define MAP_SIZE (1 << 12)
+
+static uint8_t coverage[MAP_SIZE] __attribute__((aligned(8)));
+static uint8_t seen[MAP_SIZE] __attribute__((aligned(8)));
+static uintptr_t previous_pc;
+static int nb_edges = 0;
+
+void __sanitizer_cov_trace_pc(void) {
+  uintptr_t pc = (uintptr_t)__builtin_return_address(0);
+  coverage[(pc ^ previous_pc) % MAP_SIZE]++;
+  previous_pc = pc >> 1;
+}
+
+/* Nombre de passages ramené à une classe (1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+) */
+static uint8_t bucket[256];
+
+static void init_buckets(void) {
+  for (int c = 1; c < 256; c++)
+    bucket[c] = c < 3 ? c : c == 3 ? 4 : c < 8 ? 8 : c < 16 ? 16 : c < 32 ? 32 : c < 128 ? 64 : 128;
+}
+
+static int new_coverage(void) {
+  int found = 0;
+  uint64_t *words = (uint64_t *)coverage, *seen_words = (uint64_t *)seen;
+  for (int w = 0; w < MAP_SIZE / 8; w++) {
+    if (words[w] == 0)
+      continue;
+    uint8_t *b = (uint8_t *)&words[w];
+    for (int i = 0; i < 8; i++)
+      b[i] = bucket[b[i]];
+    if ((words[w] & ~seen_words[w]) == 0)
+      continue;
+    for (int i = w * 8; i < w * 8 + 8; i++)
+      if (coverage[i] && seen[i] == 0)
+        nb_edges++;
+    seen_words[w] |= words[w];
+    found = 1;
+  }
+  return found;
+}
+
+/* --- CORPUS ET MUTATIONS --- */
+
+#define MAX_CORPUS 8192
+
+typedef struct input_s {
+  uint8_t data[MAX_INPUT_LEN];
+  size_t len;
+} input;
+
+static input *corpus = NULL;
+static int corpus_size = 0;
+static const char *corpus_dir = NULL;
+
+static unsigned long rng = 88172645463325252UL;
+
+static unsigned long next_rand(void) {
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  return rng;
+}
+
+static void add_input(const uint8_t *data, size_t len, int save) {
+  if (corpus_size == MAX_CORPUS)
+    return;
+  memcpy(corpus[corpus_size].data, data, len);
+  corpus[corpus_size++].len = len;
+  if (save && corpus_dir) {
+    char path[4096];
+    /* nommé par empreinte : plusieurs processus partagent le répertoire */
+    snprintf(path, sizeof(path), "%s/%016llx", corpus_dir, (unsigned long long)input_hash(data, len));
+    FILE *f = fopen(path, "wb");
+    if (f) {
+      fwrite(data, 1, len, f);
+      fclose(f);
+    }
+  }
+}
+
+/* Graine par défaut : une partie avec le placement standard, pour atteindre la phase de jeu */
+static void standard_seed(void) {
+  uint8_t seed[MAX_INPUT_LEN];
+  size_t len = 0;
+  int place = 0;
+  while (fuzz_ops[place] != CALL_PLACE)
+    place++;
+  seed[len++] = 0; /* REC_NEW */
+  seed[len++] = 0;
+  /* decode_arg(v + 2) == v pour les petites valeurs */
+  for (int c = 0; c < DIMENSION && len + 10 <= sizeof(seed); c++)
+    for (player p = SOUTH_P; p <= NORTH_P && standard_piece(c) != NONE; p++) {
+      seed[len++] = place;
+      seed[len++] = 0;
+      seed[len++] = standard_piece(c) + 2;
+      seed[len++] = p + 2;
+      seed[len++] = c + 2;
+    }
+  add_input(seed, len, 0);
+}
+
+static void load_corpus(const char *dir) {
+  DIR *d = opendir(dir);
+  if (d == NULL) {
+    mkdir(dir, 0755);
+    return;
+  }
+  struct dirent *ent;
+  while ((ent = readdir(d)) != NULL) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+    struct stat st;
+    if (stat(path, &st) < 0 || !S_ISREG(st.st_mode))
+      continue;
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+      continue;
+    uint8_t buf[MAX_INPUT_LEN];
+    size_t len = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    add_input(buf, len, 0);
+  }
+  closedir(d);
+}
+
+/* Quelques mutations empilées : octets modifiés, blocs insérés, retirés, dupliqués ou greffés */
+static size_t mutate(const input *in, uint8_t *out) {
+  size_t len = in->len;
+  memcpy(out, in->data, len);
+  int rounds = 1 + next_rand() % 4;
+  for (int r = 0; r < rounds; r++) {
+    size_t pos = len ? next_rand() % len : 0;
+    switch (next_rand() % 7) {
+    case 0:
+      if (len)
+        out[pos] ^= 1 << (next_rand() % 8);
+      break;
+    case 1:
+      if (len)
+        out[pos] = next_rand();
+      break;
+    case 2:
+      /* petite valeur : argument valide ou juste à côté */
+      if (len)
+        out[pos] = next_rand() % (DIMENSION + 4);
+      break;
+    case 3: {
+      /* un appel aléatoire inséré */
+      size_t n = 2 + next_rand() % 4;
+      if (len + n > MAX_INPUT_LEN)
+        break;
+      memmove(out + pos + n, out + pos, len - pos);
+      for (size_t k = 0; k < n; k++)
+        out[pos + k] = next_rand();
+      len += n;
+      break;
+    }
+    case 4: {
+      size_t n = 1 + next_rand() % 8;
+      if (n > len - pos)
+        n = len - pos;
+      memmove(out + pos, out + pos + n, len - pos - n);
+      len -= n;
+      break;
+    }
+    case 5: {
+      size_t from = len ? next_rand() % len : 0, n = 1 + next_rand() % 16;
+      if (n > len - from)
+        n = len - from;
+      if (len + n > MAX_INPUT_LEN)
+        break;
+      uint8_t chunk[16];
+      memcpy(chunk, out + from, n);
+      memmove(out + pos + n, out + pos, len - pos);
+      memcpy(out + pos, chunk, n);
+      len += n;
+      break;
+    }
+    case 6: {
+      const input *other = &corpus[next_rand() % corpus_size];
+      size_t from = other->len ? next_rand() % other->len : 0;
+      size_t n = other->len - from;
+      if (pos + n > MAX_INPUT_LEN)
+        n = MAX_INPUT_LEN - pos;
+      memcpy(out + pos, other->data + from, n);
+      len = pos + n;
+      break;
+    }
+    }
+  }
+  return len;
+}
+
+/* --- BOUCLE --- */
+
+static int timeout_s = 5;
+
+/* Chien de garde : une exécution qui ne termine pas est sauvegardée comme timeout */
+static void on_alarm(int sig) {
+  (void)sig;
+  static unsigned long last = 0;
+  static int stuck = 0;
+  if (executions != last) {
+    last = executions;
+    stuck = 0;
+    return;
+  }
+  if (++stuck < timeout_s)
+    return;
+  const char *msg = "\n ❌ timeout : l'exécution ne termine pas\n";
+  if (write(2, msg, strlen(msg)) < 0)
+    _exit(1);
+  save_input("timeout");
+  _exit(1);
+}
+
+static void on_crash(int sig) {
+  save_input("crash");
+  signal(sig, SIG_DFL);
+  raise(sig);
+}
+
+static void on_sanitizer_death(void) {
+  save_input("crash");
+}
+
+/* Sous -o, l'entrée est déjà un fichier : seuls les appels faits sont écrits */
+static void on_recording_crash(int sig) {
+  write_recording();
+  signal(sig, SIG_DFL);
+  raise(sig);
+}
+
+/* Fournie par les sanitizers ; absente sans eux, les signaux prennent le relais */
+extern void __sanitizer_set_death_callback(void (*callback)(void)) __attribute__((weak));
+
+/* UBSan (runtime séparé d'ASan avec gcc) ignore ce rappel : il termine par abort() */
+const char *__ubsan_default_options(void) {
+  return "abort_on_error=1:print_stacktrace=1";
+}
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned long *shared_executions; /* exécutions de chaque processus */
+static int nb_workers = 1;
+
+static unsigned long total_executions(void) {
+  unsigned long total = 0;
+  for (int k = 0; k < nb_workers; k++)
+    total += shared_executions[k];
+  return total;
+}
+
+/* Corpus et arcs sont ceux du processus qui affiche : absents pour le parent de -j */
+static void print_stats(const char *when, double elapsed, int with_corpus) {
+  unsigned long total = total_executions();
+  printf("%s%-8s%s %10lu exécutions  %9.0f /s", BLUE, when, RESET, total, elapsed > 0 ? total / elapsed : 0);
+  if (with_corpus)
+    printf("  corpus %5d  arcs %5d", corpus_size, nb_edges);
+  printf("\n");
+  fflush(stdout);
+}
+
+/* Un processus : couverture des graines, puis mutations jusqu'à la limite */
+static void fuzz_worker(int id, unsigned long max_runs, double max_time) {
+  rng = (rng + id * 0x9E3779B97F4A7C15UL) | 1;
+  /* deux lectures du compteur de cycles par appel : la moitié du débit */
+  trace_clock = 0;
+  /* ASan traite lui-même SIGSEGV et compagnie, mais pas SIGABRT */
+  signal(SIGABRT, on_crash);
+  if (__sanitizer_set_death_callback)
+    __sanitizer_set_death_callback(on_sanitizer_death);
+  else {
+    int sigs[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL};
+    for (int i = 0; i < 4; i++)
+      signal(sigs[i], on_crash);
+  }
+  signal(SIGALRM, on_alarm);
+  struct itimerval tick = {{1, 0}, {1, 0}};
+  setitimer(ITIMER_REAL, &tick, NULL);
+
+  int seeds = corpus_size;
+  for (int i = 0; i < seeds; i++) {
+    memset(coverage, 0, sizeof(coverage));
+    LLVMFuzzerTestOneInput(corpus[i].data, corpus[i].len);
+    if (new_coverage() && !symmetric)
+      run_input(corpus[i].data, corpus[i].len, NB_VARIANTS);
+  }
+  double start = now_s(), next_report = 1;
+  uint8_t buf[MAX_INPUT_LEN];
+  while (max_runs == 0 || executions < max_runs) {
+    size_t len = mutate(&corpus[next_rand() % corpus_size], buf);
+    memset(coverage, 0, sizeof(coverage));
+    LLVMFuzzerTestOneInput(buf, len);
+    int found = new_coverage();
+    if (found)
+      add_input(buf, len, 1);
+    if (!symmetric && (found || next_rand() % SYMMETRY_SAMPLE == 0))
+      run_input(buf, len, NB_VARIANTS);
+    if ((executions & 1023) == 0) {
+      shared_executions[id] = executions;
+      double elapsed = now_s() - start;
+      if (id == 0 && elapsed >= next_report) {
+        print_stats("", elapsed, 1);
+        next_report *= 2;
+      }
+      if (max_time > 0 && elapsed >= max_time)
+        break;
+    }
+  }
+  shared_executions[id] = executions;
+}
+
+static int fuzz(unsigned long max_runs, double max_time) {
+  corpus = malloc(MAX_CORPUS * sizeof(input));
+  shared_executions = mmap(NULL, nb_workers * sizeof(unsigned long), PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (corpus == NULL || shared_executions == MAP_FAILED) {
+    perror("fuzz");
+    return 2;
+  }
+  init_buckets();
+  if (corpus_dir)
+    load_corpus(corpus_dir);
+  if (corpus_size == 0)
+    standard_seed();
+
+  printf("%s=== FUZZING BOARD.H (DIMENSION %d, %d processus) ===%s\n\n", BGBLUE, DIMENSION, nb_workers, RESET);
+  fflush(stdout);
+  double start = now_s();
+  int failed = 0;
+  if (nb_workers == 1)
+    fuzz_worker(0, max_runs, max_time);
+  else {
+    /* processus indépendants, chacun sa graine aléatoire ; le premier plantage arrête les autres */
+    pid_t *pids = calloc(nb_workers, sizeof(pid_t));
+    for (int k = 0; k < nb_workers; k++) {
+      pids[k] = fork();
+      if (pids[k] == 0) {
+        fuzz_worker(k, max_runs ? max_runs / nb_workers + 1 : 0, max_time);
+        _exit(0);
+      }
+    }
+    for (int k = 0; k < nb_workers; k++) {
+      int status;
+      if (waitpid(-1, &status, 0) > 0 && !(WIFEXITED(status) && WEXITSTATUS(status) == 0) && !failed) {
+        failed = 1;
+        for (int j = 0; j < nb_workers; j++)
+          kill(pids[j], SIGTERM);
+      }
+    }
+    free(pids);
+  }
+  print_stats("fin", now_s() - start, nb_workers == 1);
+  if (failed)
+    printf("\n%sPlantage : l'entrée est sauvegardée (voir ci-dessus).%s\n", BGRED, RESET);
+  else
+    printf("\n%sAucun plantage en %lu exécutions.%s\n", bgyellow, total_executions(), RESET);
+  free(corpus);
+  return failed;
+}
+
+/* Rejoue une entrée en affichant chaque appel ; -o écrit les appels exécutés en enregistrement */
+static int replay_file(const char *path, const char *out) {
+  static uint8_t buf[MAX_INPUT_LEN];
+  static rec_entry seq[MAX_ENTRIES];
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    perror(path);
+    return 2;
+  }
+  size_t len = fread(buf, 1, sizeof(buf), f);
+  fclose(f);
+  int n = decode(buf, len, seq);
+  static rec_writer w;
+  if (out) {
+    if (rec_open(&w, out) < 0)
+      return 2;
+    recording = &w;
+    recorded = seq;
+    /* un plantage écrit les appels déjà faits avant de terminer */
+    signal(SIGABRT, on_recording_crash);
+    if (__sanitizer_set_death_callback)
+      __sanitizer_set_death_callback(write_recording);
+    else {
+      int sigs[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL};
+      for (int i = 0; i < 4; i++)
+        signal(sigs[i], on_recording_crash);
+    }
+  }
+  printf("%s=== %s : %d appels ===%s\n", BGBLUE, path, n, RESET);
+  verbose = 1;
+  current = buf;
+  current_len = len;
+  execute(seq, n, NB_VARIANTS);
+  if (out) {
+    write_recording();
+    rec_close(&w);
+    printf("%s%d appels écrits dans %s%s\n", BLUE, n, out, RESET);
+  }
+  printf("%s ✅ aucun plantage%s\n", GREEN, RESET);
+  return 0;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-n runs] [-T seconds] [-t timeout_s] [-s seed] [-j workers] [-d corpus_dir]\n"
+          "       %*s [-a artifacts_dir] [-y]\n"
+          "       %s [-o out.rec] input...\n",
+          prog, (int)strlen(prog), "", prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  unsigned long max_runs = 0;
+  double max_time = 0;
+  const char *out = NULL;
+  int first_file = 0;
+  rng ^= (unsigned long)time(NULL) * 2654435761UL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      max_runs = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc)
+      max_time = atof(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      timeout_s = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+      rng = strtoul(argv[++i], NULL, 10) | 1;
+    else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      nb_workers = atoi(argv[++i]) > 0 ? atoi(argv[i]) : 1;
+    else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+      corpus_dir = argv[++i];
+    else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+      artifacts = argv[++i];
+    else if (strcmp(argv[i], "-y") == 0)
+      symmetric = 1;
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      out = argv[++i];
+    else if (argv[i][0] != '-') {
+      first_file = i;
+      break;
+    } else
+      usage(argv[0]);
+  }
+  if ((first_file == 0 && out) || (out && first_file != argc - 1))
+    usage(argv[0]);
+  if (first_file == 0)
+    return fuzz(max_runs, max_time);
+  int status = 0;
+  for (int i = first_file; i < argc; i++)
+    status |= replay_file(argv[i], out);
+  return status;
+}
+
+#endif /* FUZZ_LIBFUZZER */
@@ -0,0 +1,531 @@
+#define _DEFAULT_SOURCE
+#include "engine.h"
+#include "record.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGRED "\033[101m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Minimisation d'une suite d'appels qui met un moteur en défaut.
+ *
+ * La suite est un enregistrement (record.h, par exemple produit par
+ * « make runtests RECORD=... »). Elle est rejouée à la fois sur le moteur
+ * étudié et sur le moteur de référence, tous deux chargés en .so
+ * (engine.h) : l'échec est la première divergence de résultat, ou un
+ * plantage, ou un dépassement de temps du moteur étudié.
+ *
+ * La suite est réduite par delta-debugging (retrait de blocs d'appels de
+ * plus en plus petits), puis ses arguments sont simplifiés (rapprochés de
+ * 0) tant que l'échec est le même : même nature, sur la même fonction.
+ * Chaque candidat est exécuté dans un processus fils, plusieurs à la fois.
+ * La suite minimale est affichée sous forme de TEST pour assertions.c, et
+ * écrite en enregistrement avec -o.
+ *   ./minimize [-r arbitre.so] [-j processus] [-t timeout_ms] [-o sortie.rec]
+ *              [-n nom_du_test] moteur.so fichier.rec
+ *
+ * Code de retour : 0 si la suite a été minimisée, 2 en cas d'erreur
+ * (chargement, fichier illisible ou non écrit), 3 si le moteur n'échoue pas
+ * sur cette suite (rien à minimiser).
+ */
+
+#define NO_FAILURE 3
+
+enum { V_PASS, V_DIVERGE, V_CRASH, V_TIMEOUT };
+
+static const char *verdict_names[] = {"aucun échec", "divergence", "plantage", "timeout"};
+
+/* Verdict d'une exécution, écrit par le processus fils */
+typedef struct verdict_s {
+  int kind;
+  int index;       /* appel en échec */
+  int got, want;   /* résultats du moteur et de la référence */
+  int in_referee;  /* 1 si l'appel en cours est fait à la référence */
+} verdict;
+
+static engine referee, student;
+
+/* --- EXÉCUTION --- */
+
+static rec_entry *seq = NULL;
+static int seq_len = 0;
+static int max_id = 0;
+
+/* Exécute une entrée sur un moteur ; les parties absentes sont ignorées */
+static int exec_entry(const engine *e, board *games, const rec_entry *en) {
+  board g = (en->game >= 0 && en->game <= max_id) ? games[en->game] : NULL;
+  switch (en->op) {
+  case REC_NEW:
+    if (en->result < 0 || en->result > max_id)
+      return 0;
+    games[en->result] = e->new_game();
+    return games[en->result] != NULL;
+  case REC_COPY:
+    if (g == NULL || en->result < 0 || en->result > max_id)
+      return 0;
+    games[en->result] = e->copy_game(g);
+    return games[en->result] != NULL;
+  case REC_DESTROY:
+    if (g != NULL)
+      e->destroy_game(g);
+    if (en->game >= 0 && en->game <= max_id)
+      games[en->game] = NULL;
+    return 0;
+  case REC_NEXT_PLAYER:
+    return e->next_player(en->args[0]);
+  default: {
+    if (g == NULL)
+      return ANY_RESULT;
+    step s = {en->op, en->args[0], en->args[1], en->args[2], 0, 0};
+    engine_use(e);
+    return step_exec(g, &s, NULL);
+  }
+  }
+}
+
+/* Rejoue seq[0..n) sur les deux moteurs, appel par appel */
+static void run(const rec_entry *s, int n, verdict *v) {
+  board *ref_games = calloc(max_id + 1, sizeof(board));
+  board *games = calloc(max_id + 1, sizeof(board));
+  for (int i = 0; i < n; i++) {
+    v->index = i;
+    v->in_referee = 1;
+    int want = exec_entry(&referee, ref_games, &s[i]);
+    v->in_referee = 0;
+    int got = exec_entry(&student, games, &s[i]);
+    if (got != want) {
+      v->got = got;
+      v->want = want;
+      v->kind = V_DIVERGE;
+      return;
+    }
+  }
+  v->kind = V_PASS;
+}
+
+/* --- CANDIDATS --- */
+
+/* Un candidat : retrait de seq[from..to), ou remplacement d'un argument */
+typedef struct candidate_s {
+  int from, to;
+  int entry, arg, value;  /* entry < 0 pour un retrait */
+} candidate;
+
+static int apply(const candidate *c, rec_entry *out) {
+  if (c->entry >= 0) {
+    memcpy(out, seq, seq_len * sizeof(rec_entry));
+    out[c->entry].args[c->arg] = c->value;
+    return seq_len;
+  }
+  memcpy(out, seq, c->from * sizeof(rec_entry));
+  memcpy(out + c->from, seq + c->to, (seq_len - c->to) * sizeof(rec_entry));
+  return seq_len - (c->to - c->from);
+}
+
+static int nb_workers = 1, timeout_ms = 1000;
+static verdict *slots = NULL;
+static verdict target;
+static int target_op;
+static long evaluated = 0;
+
+/* Exécute une suite dans un processus fils et lit son verdict */
+static void start_run(const rec_entry *s, int n, verdict *slot, pid_t *pid) {
+  memset(slot, 0, sizeof(*slot));
+  slot->kind = -1;
+  *pid = fork();
+  if (*pid == 0) {
+    struct itimerval it = {{0, 0}, {timeout_ms / 1000, (timeout_ms % 1000) * 1000}};
+    setitimer(ITIMER_REAL, &it, NULL);
+    run(s, n, slot);
+    _exit(0);
+  }
+}
+
+static void finish_run(pid_t pid, verdict *slot) {
+  int status;
+  waitpid(pid, &status, 0);
+  evaluated++;
+  if (WIFSIGNALED(status)) {
+    slot->kind = WTERMSIG(status) == SIGALRM ? V_TIMEOUT : V_CRASH;
+    slot->got = WTERMSIG(status);
+  } else if (slot->kind < 0) {
+    slot->kind = V_CRASH; /* sortie prématurée du moteur */
+    slot->got = -1;
+  }
+}
+
+/* Même échec que la suite de départ : même nature, même fonction, côté moteur */
+static int same_failure(const verdict *v, const rec_entry *s) {
+  if (v->kind != target.kind || v->in_referee || s[v->index].op != target_op)
+    return 0;
+  return v->kind != V_CRASH || v->got == target.got;
+}
+
+/* Évalue les candidats par lots parallèles, retourne le premier qui échoue */
+static int first_failing(const candidate *cands, int nb, rec_entry **bufs, verdict *found) {
+  pid_t *pids = malloc(nb_workers * sizeof(pid_t));
+  int result = -1;
+  for (int base = 0; base < nb && result < 0; base += nb_workers) {
+    int batch = nb - base < nb_workers ? nb - base : nb_workers;
+    for (int k = 0; k < batch; k++) {
+      int n = apply(&cands[base + k], bufs[k]);
+      start_run(bufs[k], n, &slots[k], &pids[k]);
+    }
+    for (int k = 0; k < batch; k++)
+      finish_run(pids[k], &slots[k]);
+    for (int k = 0; k < batch && result < 0; k++)
+      if (same_failure(&slots[k], bufs[k])) {
+        result = base + k;
+        *found = slots[k];
+      }
+  }
+  free(pids);
+  return result;
+}
+
+/* Adopte un candidat, en coupant tout ce qui suit l'appel en échec */
+static void accept(const candidate *c, const verdict *v) {
+  rec_entry *next = malloc(seq_len * sizeof(rec_entry));
+  apply(c, next);
+  free(seq);
+  seq = next;
+  seq_len = v->index + 1;
+  target = *v;
+}
+
+/* Delta-debugging : retrait de blocs, de plus en plus fins */
+static int reduce_calls(rec_entry **bufs) {
+  int changed = 0, n = 2;
+  candidate *cands = malloc(seq_len * sizeof(candidate));
+  while (seq_len >= 2) {
+    if (n > seq_len)
+      n = seq_len;
+    int nb = 0, chunk = (seq_len + n - 1) / n;
+    for (int from = 0; from < seq_len; from += chunk)
+      cands[nb++] = (candidate){from, from + chunk < seq_len ? from + chunk : seq_len, -1, 0, 0};
+    verdict v;
+    int i = first_failing(cands, nb, bufs, &v);
+    if (i >= 0) {
+      accept(&cands[i], &v);
+      changed = 1;
+      n = n > 2 ? n - 1 : 2;
+      continue;
+    }
+    if (n == seq_len)
+      break;
+    n *= 2;
+  }
+  free(cands);
+  return changed;
+}
+
+/* Rapproche chaque argument de 0 */
+static int simplify_args(rec_entry **bufs) {
+  int changed = 0;
+  for (int e = 0; e < seq_len; e++)
+    for (int a = 0; a < rec_nb_args(seq[e].op); a++) {
+      int value;
+      while ((value = seq[e].args[a]) != 0) {
+        candidate cands[3];
+        int nb = 0;
+        cands[nb++] = (candidate){0, 0, e, a, 0};
+        if (value > 2 || value < -2)
+          cands[nb++] = (candidate){0, 0, e, a, value / 2};
+        if (value > 1 || value < -1)
+          cands[nb++] = (candidate){0, 0, e, a, value > 0 ? value - 1 : value + 1};
+        verdict v;
+        int i = first_failing(cands, nb, bufs, &v);
+        if (i < 0)
+          break;
+        accept(&cands[i], &v);
+        changed = 1;
+        if (e >= seq_len)
+          return changed;
+      }
+    }
+  return changed;
+}
+
+/* --- SORTIE EN TEST C --- */
+
+enum { A_INT, A_SIZE, A_PLAYER, A_DIR, A_CODE, A_BOOL };
+
+static int arg_kind(int op, int i) {
+  switch (op) {
+  case CALL_PLACE: return i == 0 ? A_SIZE : i == 1 ? A_PLAYER : A_INT;
+  case CALL_PICK: return i == 0 ? A_PLAYER : A_INT;
+  case CALL_MOVE:
+  case CALL_POSSIBLE: return A_DIR;
+  case CALL_AVAILABLE: return i == 0 ? A_SIZE : A_PLAYER;
+  case REC_NEXT_PLAYER: return A_PLAYER;
+  default: return A_INT;
+  }
+}
+
+static int result_kind(int op) {
+  switch (op) {
+  case CALL_PLACE:
+  case CALL_PICK:
+  case CALL_MOVE:
+  case CALL_SWAP:
+  case CALL_CANCEL_MOVEMENT:
+  case CALL_CANCEL_STEP: return A_CODE;
+  case CALL_POSSIBLE: return A_BOOL;
+  case CALL_SIZE:
+  case CALL_HELD: return A_SIZE;
+  case CALL_WINNER:
+  case CALL_OWNER:
+  case REC_NEXT_PLAYER: return A_PLAYER;
+  default: return A_INT;
+  }
+}
+
+static const char *value_text(int kind, int v, char *buf) {
+  static const char *sizes[] = {"NONE", "ONE", "TWO", "THREE"};
+  static const char *players[] = {"NO_PLAYER", "SOUTH_P", "NORTH_P"};
+  static const char *dirs[] = {"GOAL", "SOUTH", "NORTH", "EAST", "WEST"};
+  static const char *codes[] = {"OK", "EMPTY", "FORBIDDEN", "PARAM"};
+  if (kind == A_SIZE && v >= 0 && v <= 3)
+    return sizes[v];
+  if (kind == A_PLAYER && v >= 0 && v <= 2)
+    return players[v];
+  if (kind == A_DIR && v >= 0 && v <= 4)
+    return dirs[v];
+  if (kind == A_CODE && v >= 0 && v <= 3)
+    return codes[v];
+  if (kind == A_BOOL && (v == 0 || v == 1))
+    return v ? "true" : "false";
+  sprintf(buf, "%d", v);
+  return buf;
+}
+
+static const char *api_names[NB_CALLS] = {
+    "place_piece", "pick_piece", "move_piece", "swap_piece", "cancel_movement", "cancel_step",
+    "is_move_possible", "get_piece_size", "get_winner", "southmost_occupied_line",
+    "northmost_occupied_line", "picked_piece_owner", "picked_piece_size", "picked_piece_line",
+    "picked_piece_column", "movement_left", "nb_pieces_available", "board"};
+
+/* Parties renumérotées dans l'ordre de création : g0, g1... */
+static int *var = NULL;
+
+/* Texte de l'appel, sans point-virgule */
+static void call_text(const rec_entry *e, char *out, size_t len) {
+  char buf[16];
+  int n = 0;
+  if (e->op == REC_NEXT_PLAYER) {
+    snprintf(out, len, "next_player(%s)", value_text(A_PLAYER, e->args[0], buf));
+    return;
+  }
+  n += snprintf(out + n, len - n, "%s(g%d", api_names[e->op], var[e->game]);
+  for (int i = 0; i < rec_nb_args(e->op); i++)
+    n += snprintf(out + n, len - n, ", %s", value_text(arg_kind(e->op, i), e->args[i], buf));
+  snprintf(out + n, len - n, ")");
+}
+
+static void emit_test(FILE *f, const char *name, const char *source) {
+  char call[128], buf[16];
+  char *live = calloc(max_id + 1, 1);
+  int nb_vars = 0;
+  var = calloc(max_id + 1, sizeof(int));
+  for (int i = 0; i < seq_len; i++)
+    if (seq[i].op == REC_NEW || seq[i].op == REC_COPY)
+      var[seq[i].result] = nb_vars++;
+  fprintf(f, "/* Suite minimale produite par minimize (%s) : %s */\n\n", source, verdict_names[target.kind]);
+  fprintf(f, "TEST(%s, \"Minimized\") {\n", name);
+  for (int i = 0; i < seq_len; i++) {
+    const rec_entry *e = &seq[i];
+    int has_game = e->game >= 0 && e->game <= max_id && live[e->game];
+    if (e->op == REC_NEW) {
+      fprintf(f, "  board g%d = new_game();\n", var[e->result]);
+      live[e->result] = 1;
+      continue;
+    }
+    if (e->op == REC_COPY) {
+      if (has_game) {
+        fprintf(f, "  board g%d = copy_game(g%d);\n", var[e->result], var[e->game]);
+        live[e->result] = 1;
+      }
+      continue;
+    }
+    if (e->op == REC_DESTROY) {
+      if (has_game) {
+        fprintf(f, "  destroy_game(g%d);\n", var[e->game]);
+        live[e->game] = 0;
+      }
+      continue;
+    }
+    if (e->op != REC_NEXT_PLAYER && !has_game)
+      continue;
+    call_text(e, call, sizeof(call));
+    if (i < seq_len - 1) {
+      fprintf(f, "  %s;\n", call);
+    } else if (target.kind == V_DIVERGE) {
+      const char *want = value_text(result_kind(e->op), target.want, buf);
+      fprintf(f, "\n  int rc = %s;\n", call);
+      fprintf(f, "  ASSERT(rc == %s, rc, \"%s == %s\");\n\n", want, call, want);
+    } else {
+      fprintf(f, "\n  // %s ici\n  %s;\n\n", verdict_names[target.kind], call);
+    }
+  }
+  for (int id = 0; id <= max_id; id++)
+    if (live[id])
+      fprintf(f, "  destroy_game(g%d);\n", var[id]);
+  fprintf(f, "  CATPASS(\"Minimized: %s\");\n}\n", name + (strncmp(name, "test_", 5) == 0 ? 5 : 0));
+  free(live);
+  free(var);
+}
+
+static void default_name(const char *path, char *out, size_t len) {
+  const char *base = strrchr(path, '/');
+  base = base ? base + 1 : path;
+  size_t n = snprintf(out, len, "test_min_");
+  for (; *base && *base != '.' && n + 1 < len; base++)
+    out[n++] = (*base >= 'a' && *base <= 'z') || (*base >= 'A' && *base <= 'Z') ||
+                       (*base >= '0' && *base <= '9') ? *base : '_';
+  out[n] = '\0';
+}
+
+/* --- PROGRAMME --- */
+
+static double now_s(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-r referee.so] [-j workers] [-t timeout_ms] [-o out.rec] [-n test_name] engine.so file.rec\n",
+          prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  const char *referee_path = "reference/board.so", *engine_path = NULL, *path = NULL, *out_path = NULL;
+  char name[64] = "";
+  nb_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+      referee_path = argv[++i];
+    else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      nb_workers = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      timeout_ms = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      out_path = argv[++i];
+    else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      snprintf(name, sizeof(name), "%s", argv[++i]);
+    else if (argv[i][0] != '-' && engine_path == NULL)
+      engine_path = argv[i];
+    else if (argv[i][0] != '-' && path == NULL)
+      path = argv[i];
+    else
+      usage(argv[0]);
+  }
+  if (path == NULL)
+    usage(argv[0]);
+  if (nb_workers < 1)
+    nb_workers = 1;
+  if (name[0] == '\0')
+    default_name(path, name, sizeof(name));
+
+  if (engine_load(&referee, referee_path) < 0 || engine_load(&student, engine_path) < 0)
+    return 2;
+  rec_reader r;
+  if (rec_map(&r, path) < 0)
+    return 2;
+  rec_entry e;
+  int cap = 0, status;
+  while ((status = rec_next(&r, &e)) == 1) {
+    if (seq_len == cap) {
+      cap = cap ? cap * 2 : 1024;
+      seq = realloc(seq, cap * sizeof(rec_entry));
+    }
+    seq[seq_len++] = e;
+    if (e.game > max_id)
+      max_id = e.game;
+    if ((e.op == REC_NEW || e.op == REC_COPY) && e.result > max_id)
+      max_id = e.result;
+  }
+  rec_unmap(&r);
+  if (status < 0)
+    printf("%sEnregistrement tronqué : %d appels lus.%s\n", RED, seq_len, RESET);
+
+  printf("%s=== MINIMISATION : %s, %d appels, %d processus ===%s\n\n", BGBLUE, path, seq_len, nb_workers, RESET);
+  fflush(stdout);
+
+  slots = mmap(NULL, nb_workers * sizeof(verdict), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (slots == MAP_FAILED) {
+    perror("mmap");
+    return 2;
+  }
+  rec_entry **bufs = malloc(nb_workers * sizeof(rec_entry *));
+  for (int k = 0; k < nb_workers; k++)
+    bufs[k] = malloc((seq_len ? seq_len : 1) * sizeof(rec_entry));
+
+  double start = now_s();
+  pid_t pid;
+  start_run(seq, seq_len, &slots[0], &pid);
+  finish_run(pid, &slots[0]);
+  target = slots[0];
+  if (target.kind == V_PASS || target.in_referee) {
+    printf("%s 🎉 aucun échec du moteur sur cette suite %s\n", GREEN, RESET);
+    return NO_FAILURE;
+  }
+  int initial = seq_len;
+  seq_len = target.index + 1;
+  target_op = seq[target.index].op;
+  printf("%sÉchec de départ : %s sur %s, appel %d.%s\n", RED, verdict_names[target.kind], rec_op_name(target_op),
+         target.index, RESET);
+  fflush(stdout);
+
+  int changed = 1;
+  while (changed) {
+    changed = reduce_calls(bufs);
+    changed |= simplify_args(bufs);
+  }
+  double elapsed = now_s() - start;
+
+  printf("%s%d appels → %d appels, %ld exécutions en %.2f s.%s\n\n", bgyellow, initial, seq_len, evaluated, elapsed,
+         RESET);
+  emit_test(stdout, name, path);
+
+  int status_out = 0;
+  if (out_path) {
+    /* résultats de la référence : replay montre la divergence sur le moteur étudié */
+    rec_writer *w = malloc(sizeof(rec_writer));
+    board *games = calloc(max_id + 1, sizeof(board));
+    if (rec_open(w, out_path) == 0) {
+      for (int i = 0; i < seq_len; i++) {
+        rec_entry out = seq[i];
+        int res = exec_entry(&referee, games, &seq[i]);
+        if (out.op != REC_NEW && out.op != REC_COPY)
+          out.result = res;
+        rec_write(w, &out);
+      }
+      rec_close(w);
+    } else {
+      status_out = 2;
+    }
+    free(games);
+    free(w);
+  }
+
+  for (int k = 0; k < nb_workers; k++)
+    free(bufs[k]);
+  free(bufs);
+  free(seq);
+  return status_out;
+}
@@ -0,0 +1,596 @@
+#define _DEFAULT_SOURCE
+#include "board.h"
+#include "record.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGRED "\033[101m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Parties aléatoires en masse : traces d'appels légaux (record.h) pour le
+ * test différentiel des moteurs, et statistiques de jeu (gains de SOUTH_P,
+ * qui commence, de NORTH_P, longueur des parties).
+ *
+ * Le moteur est propre à cet outil. LANES parties sont tenues en structure
+ * de tableaux, une partie par voie, et avancent toutes d'un appel de l'API
+ * à chaque pas, sans branchement : chaque plateau est un jeu de plans de
+ * DIMENSION² bits (occupation, deux bits de taille, arêtes parcourues par le
+ * mouvement en cours) et les cas se résolvent par sélection. Le même noyau
+ * est compilé pour AVX-512, pour AVX2 et sans vectorisation ; le meilleur
+ * disponible est choisi à l'exécution.
+ *
+ * Politique : le joueur au trait prend une pièce au hasard sur sa ligne la
+ * plus avancée ; chaque pas est ensuite tiré uniformément parmi les
+ * directions possibles et le remplacement (vers une case vide tirée au
+ * hasard). Sans issue, le mouvement est annulé et le joueur reprend une
+ * pièce ; une partie sans vainqueur après -m tours est nulle, une partie où
+ * un joueur ne trouve pas de tour est bloquée.
+ *
+ *   ./playout [-n parties] [-j threads] [-s graine] [-m tours] [-p] [-k noyau] [-c] [-o traces.rec]
+ *   -n   nombre de parties (100000 par défaut)
+ *   -s   graine ; avec -j 1, mêmes parties et mêmes traces
+ *   -m   nombre maximal de tours d'une partie (200 par défaut)
+ *   -p   placement standard (1 1 2 2 3 3), aléatoire sinon
+ *   -k   avx512, avx2 ou scalar (le plus rapide disponible par défaut)
+ *   -c   rejoue chaque partie sur le moteur lié (la référence) et compare
+ *   -o   traces : par partie, placement, appels joués et résultats attendus,
+ *        avec is_move_possible avant chaque pas ; à rejouer par ./replay
+ */
+
+#if DIMENSION * DIMENSION > 64
+#error "playout : un plateau tient dans 64 bits (DIMENSION <= 8)"
+#endif
+
+#define LANES 32
+#define SQUARES (DIMENSION * DIMENSION)
+#define FULL (~0ULL >> (64 - SQUARES))
+/* annulations successives au-delà desquelles un joueur est considéré bloqué */
+#define MAX_CANCELS 64
+
+/* --- NOYAU --- */
+
+/* Les champs sont des tableaux de 64 bits indicés par la voie : une même
+ * instruction vectorielle traite plusieurs parties */
+typedef struct batch_s {
+  /* plateau, hors pièce en main : occupation, taille = lo + 2 × hi */
+  uint64_t occ[LANES], lo[LANES], hi[LANES];
+  /* arêtes parcourues : bit c pour (c, c + DIMENSION) et pour (c, c + 1) */
+  uint64_t vused[LANES], hused[LANES];
+  /* pièce en main (held = 0 : aucune), position, case de départ, pas restants */
+  uint64_t held[LANES], line[LANES], column[LANES], origin[LANES], left[LANES];
+  uint64_t player[LANES], winner[LANES], turns[LANES], cancels[LANES], done[LANES];
+  uint64_t rng[LANES];
+  /* dernier appel joué par chaque voie : ::call, argument, directions possibles avant l'appel */
+  uint64_t call[LANES], arg[LANES], legal[LANES];
+} __attribute__((aligned(64))) batch;
+
+typedef void (*kernel)(batch *b, uint64_t max_turns, uint64_t one);
+
+static inline uint64_t popcount64(uint64_t x) {
+  x -= (x >> 1) & 0x5555555555555555ULL;
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  x += x >> 8;
+  x += x >> 16;
+  x += x >> 32;
+  return x & 0x7f;
+}
+
+/* Une étape de la dichotomie de select_bit : moitié basse de width bits, ou moitié haute */
+static inline void select_half(uint64_t *x, uint64_t *r, uint64_t *index, uint64_t width) {
+  uint64_t low = popcount64(*x & ((1ULL << width) - 1));
+  uint64_t up = *r >= low;
+  *r -= up ? low : 0;
+  *x = up ? *x >> width : *x;
+  *index += up ? width : 0;
+}
+
+/* Indice du r-ième bit à 1 de x (r < popcount(x)) ; sans boucle, le noyau se vectorise */
+static inline uint64_t select_bit(uint64_t x, uint64_t r) {
+  uint64_t index = 0;
+  select_half(&x, &r, &index, 32);
+  select_half(&x, &r, &index, 16);
+  select_half(&x, &r, &index, 8);
+  select_half(&x, &r, &index, 4);
+  select_half(&x, &r, &index, 2);
+  select_half(&x, &r, &index, 1);
+  return index;
+}
+
+/* Ligne d'une case (< 64), sans division */
+static inline uint64_t line_of(uint64_t square) {
+  return (square * (65536 / DIMENSION + 1)) >> 16;
+}
+
+/* Ligne la plus au sud (au nord) occupée : bit à 1 le plus bas (le plus haut) */
+static inline uint64_t front_line(uint64_t occ, uint64_t player) {
+  uint64_t smear = occ;
+  smear |= smear >> 1;
+  smear |= smear >> 2;
+  smear |= smear >> 4;
+  smear |= smear >> 8;
+  smear |= smear >> 16;
+  smear |= smear >> 32;
+  uint64_t lowest = popcount64((occ & -occ) - 1), highest = popcount64(smear) - 1;
+  return line_of(player == SOUTH_P ? lowest : highest);
+}
+
+/* c ? a : b pour c valant 0 ou 1, sans branchement */
+static inline uint64_t blend(uint64_t c, uint64_t a, uint64_t b) {
+  return (a & -c) | (b & (c - 1));
+}
+
+/* Bit i de x, 0 ou 1 */
+static inline uint64_t bit_at(uint64_t x, uint64_t i) {
+  return (x >> (i & 63)) & 1;
+}
+
+/* Un appel par voie : prise, pas, remplacement ou annulation. Les conditions
+ * valent 0 ou 1 et se combinent par & et | : le corps de boucle est sans
+ * branchement, donc vectorisable sur les voies. GCC ne vectorise pas le
+ * décalage d'une constante d'un nombre variable de bits (1 << case) : le 1
+ * est passé en paramètre */
+static inline __attribute__((always_inline)) void advance(batch *b, uint64_t max_turns, uint64_t one) {
+  for (int i = 0; i < LANES; i++) {
+    uint64_t x = b->rng[i];
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    /* deux tirages indépendants : choix de l'action, puis case de remplacement */
+    uint64_t r = x & 0xffffffff, r2 = x >> 32;
+
+    uint64_t occ = b->occ[i], lo = b->lo[i], hi = b->hi[i], vused = b->vused[i], hused = b->hused[i];
+    uint64_t held = b->held[i], line = b->line[i], column = b->column[i], origin = b->origin[i];
+    uint64_t left = b->left[i], player = b->player[i], turns = b->turns[i], cancels = b->cancels[i];
+    uint64_t keep = b->done[i], holding = held != 0, picking = held == 0;
+    uint64_t pos = line * DIMENSION + column, bit = one << pos;
+
+    /* prise : pièce au hasard sur la ligne la plus avancée */
+    uint64_t front = front_line(occ, player);
+    uint64_t candidates = occ & (((one << DIMENSION) - one) << (front * DIMENSION));
+
+    /* en main : directions possibles, comme is_move_possible */
+    uint64_t under = bit_at(lo, pos) | bit_at(hi, pos) << 1;
+    uint64_t effective = blend(left == 0, under, left);
+    uint64_t land = effective == 1;
+    uint64_t s_ok = (line > 0) & (bit_at(vused, pos - DIMENSION) ^ 1) & ((bit_at(occ, pos - DIMENSION) ^ 1) | land);
+    uint64_t n_ok = (line < DIMENSION - 1) & (bit_at(vused, pos) ^ 1) & ((bit_at(occ, pos + DIMENSION) ^ 1) | land);
+    uint64_t e_ok = (column < DIMENSION - 1) & (bit_at(hused, pos) ^ 1) & ((bit_at(occ, pos + 1) ^ 1) | land);
+    uint64_t w_ok = (column > 0) & (bit_at(hused, pos - 1) ^ 1) & ((bit_at(occ, pos - 1) ^ 1) | land);
+    uint64_t goal_ok = land & (line == blend(player == SOUTH_P, DIMENSION - 1, 0));
+    uint64_t legal = goal_ok | s_ok << SOUTH | n_ok << NORTH | e_ok << EAST | w_ok << WEST;
+    uint64_t empty = FULL & ~occ;
+    uint64_t swap_ok = (left == 0) & (empty != 0);
+    uint64_t nb_moves = popcount64(legal), nb_options = nb_moves + swap_ok;
+    uint64_t choice = (r * nb_options) >> 32;
+    uint64_t swapping = holding & swap_ok & (choice == nb_moves);
+    uint64_t cancelling = holding & (nb_options == 0);
+    uint64_t moving = holding & (swapping ^ 1) & (cancelling ^ 1);
+
+    /* un seul tirage de bit : pièce prise, direction ou case de remplacement */
+    uint64_t set = blend(picking, candidates, blend(swapping, empty, legal));
+    uint64_t rank = blend(picking, (r * popcount64(candidates)) >> 32,
+                          blend(swapping, (r2 * popcount64(empty)) >> 32, choice));
+    uint64_t chosen = select_bit(set, rank);
+
+    /* pas dans la direction chosen */
+    uint64_t goal = moving & (chosen == GOAL);
+    uint64_t dl = (chosen == NORTH) - (chosen == SOUTH), dc = (chosen == EAST) - (chosen == WEST);
+    uint64_t next_pos = (pos + dl * DIMENSION + dc) & 63, next_bit = one << next_pos;
+    uint64_t next_left = effective - 1;
+    uint64_t drop = moving & (goal ^ 1) & (next_left == 0) & (bit_at(occ, next_pos) ^ 1);
+    uint64_t walk = moving & (goal ^ 1) & (drop ^ 1);
+    uint64_t end_turn = drop | swapping;
+
+    /* pièce posée : au bout du pas, sur la case de remplacement ou à son départ */
+    uint64_t target = blend(drop, next_bit, blend(swapping, one << (chosen & 63), one << origin));
+    uint64_t placed = target & -(drop | cancelling | swapping);
+    uint64_t placed_size = blend(swapping, under, held);
+    uint64_t n_occ = occ | placed;
+    uint64_t n_lo = (lo & ~placed) | (placed & -(placed_size & 1));
+    uint64_t n_hi = (hi & ~placed) | (placed & -(placed_size >> 1));
+    /* remplacement : la pièce en main prend la place de celle qui est déplacée */
+    uint64_t here = bit & -swapping;
+    n_lo = (n_lo & ~here) | (here & -(held & 1));
+    n_hi = (n_hi & ~here) | (here & -(held >> 1));
+    /* prise : la case est vidée */
+    uint64_t taken = (one << (chosen & 63)) & -picking;
+    n_occ &= ~taken;
+    n_lo &= ~taken;
+    n_hi &= ~taken;
+
+    uint64_t picked = bit_at(lo, chosen) | bit_at(hi, chosen) << 1;
+    uint64_t n_held = blend(picking, picked, held & -walk);
+    uint64_t n_line = blend(picking, front, blend(walk, line + dl, line));
+    uint64_t n_column = blend(picking, chosen - front * DIMENSION, blend(walk, column + dc, column));
+    uint64_t n_left = blend(picking, picked, blend(walk, next_left, left));
+    uint64_t edge_v = blend(chosen == NORTH, bit, (bit >> DIMENSION) & -(chosen == SOUTH));
+    uint64_t edge_h = blend(chosen == EAST, bit, (bit >> 1) & -(chosen == WEST));
+    uint64_t n_vused = (vused | (edge_v & -walk)) & -holding;
+    uint64_t n_hused = (hused | (edge_h & -walk)) & -holding;
+    uint64_t n_turns = turns + end_turn;
+    uint64_t n_cancels = (cancels + cancelling) & (end_turn - 1);
+    uint64_t n_done = goal | (n_turns >= max_turns) | (n_cancels >= MAX_CANCELS);
+
+    /* une voie terminée attend d'être relancée : son état ne change plus */
+    b->rng[i] = blend(keep, b->rng[i], x);
+    b->occ[i] = blend(keep, occ, n_occ);
+    b->lo[i] = blend(keep, lo, n_lo);
+    b->hi[i] = blend(keep, hi, n_hi);
+    b->vused[i] = blend(keep, vused, n_vused);
+    b->hused[i] = blend(keep, hused, n_hused);
+    b->held[i] = blend(keep, held, n_held);
+    b->line[i] = blend(keep, line, n_line);
+    b->column[i] = blend(keep, column, n_column);
+    b->origin[i] = blend(keep | holding, origin, chosen);
+    b->left[i] = blend(keep, left, n_left);
+    b->player[i] = blend(keep | (end_turn ^ 1), player, 3 - player);
+    b->winner[i] = blend(keep | (goal ^ 1), b->winner[i], player);
+    b->turns[i] = blend(keep, turns, n_turns);
+    b->cancels[i] = blend(keep, cancels, n_cancels);
+    b->done[i] = keep | n_done;
+    b->call[i] = blend(picking, CALL_PICK, blend(swapping, CALL_SWAP, blend(cancelling, CALL_CANCEL_MOVEMENT, CALL_MOVE)));
+    b->arg[i] = chosen;
+    b->legal[i] = legal;
+  }
+}
+
+/* Même noyau, trois compilations : AVX-512 (8 voies par instruction), AVX2 (4),
+ * et sans vectorisation. SSE2 n'a pas de décalage variable par voie sur 64 bits :
+ * le x86-64 de base n'apporterait rien de plus que le scalaire */
+__attribute__((optimize("no-tree-vectorize"))) static void advance_scalar(batch *b, uint64_t max_turns, uint64_t one) {
+  advance(b, max_turns, one);
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) static void advance_avx2(batch *b, uint64_t max_turns, uint64_t one) {
+  advance(b, max_turns, one);
+}
+
+__attribute__((target("avx512f"))) static void advance_avx512(batch *b, uint64_t max_turns, uint64_t one) {
+  advance(b, max_turns, one);
+}
+#endif
+
+/* Noyau demandé, ou le plus rapide disponible si *name est NULL */
+static kernel find_kernel(const char **name) {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (*name == NULL)
+    *name = __builtin_cpu_supports("avx512f") ? "avx512" : __builtin_cpu_supports("avx2") ? "avx2" : "scalar";
+  if (strcmp(*name, "avx512") == 0)
+    return __builtin_cpu_supports("avx512f") ? advance_avx512 : NULL;
+  if (strcmp(*name, "avx2") == 0)
+    return __builtin_cpu_supports("avx2") ? advance_avx2 : NULL;
+#endif
+  if (*name == NULL)
+    *name = "scalar";
+  return strcmp(*name, "scalar") == 0 ? advance_scalar : NULL;
+}
+
+/* --- PARTIES --- */
+
+typedef struct options_s {
+  long nb_games;
+  uint64_t seed, max_turns;
+  int standard, check;
+  kernel advance;
+} options;
+
+static options opt = {100000, 1, 200, 0, 0, NULL};
+static long started = 0; /* parties distribuées aux voies, tous threads confondus */
+
+static rec_writer *out = NULL;
+static pthread_mutex_t out_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Appels d'une partie en cours, gardés jusqu'à sa fin */
+typedef struct trace_s {
+  rec_entry *entries;
+  int count, cap;
+} trace;
+
+typedef struct worker_s {
+  pthread_t thread;
+  int index;
+  batch *b;
+  trace traces[LANES];
+  /* résultats */
+  long games, wins[NB_PLAYERS + 1], draws, blocked, turns, calls, mismatches;
+} worker;
+
+static uint64_t splitmix(uint64_t *s) {
+  uint64_t z = (*s += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+static void push(trace *t, int op, int game, int a, int b, int c, int result) {
+  if (t->count == t->cap) {
+    t->cap = t->cap ? 2 * t->cap : 1024;
+    t->entries = realloc(t->entries, t->cap * sizeof(rec_entry));
+  }
+  t->entries[t->count++] = (rec_entry){op, game, {a, b, c}, result};
+}
+
+static int game_id(worker *w, int lane) {
+  return w->index * LANES + lane;
+}
+
+/* Nouvelle partie dans la voie : placement sur les lignes de départ */
+static void new_lane_game(worker *w, int lane) {
+  batch *b = w->b;
+  uint64_t s = b->rng[lane];
+  b->occ[lane] = b->lo[lane] = b->hi[lane] = b->vused[lane] = b->hused[lane] = 0;
+  b->held[lane] = b->line[lane] = b->column[lane] = b->origin[lane] = b->left[lane] = 0;
+  b->player[lane] = SOUTH_P;
+  b->winner[lane] = NO_PLAYER;
+  b->turns[lane] = b->cancels[lane] = b->done[lane] = 0;
+  trace *t = &w->traces[lane];
+  if (out || opt.check)
+    push(t, REC_NEW, 0, 0, 0, 0, game_id(w, lane));
+  for (player p = SOUTH_P; p <= NORTH_P; p++) {
+    /* pièces dans l'ordre standard (1 1 2 2 3 3), colonnes mélangées sauf avec -p */
+    int columns[DIMENSION];
+    for (int c = 0; c < DIMENSION; c++)
+      columns[c] = c;
+    for (int c = DIMENSION - 1; c > 0 && !opt.standard; c--) {
+      int k = splitmix(&s) % (c + 1), tmp = columns[c];
+      columns[c] = columns[k];
+      columns[k] = tmp;
+    }
+    int line = p == SOUTH_P ? 0 : DIMENSION - 1;
+    for (int k = 0; k < NB_SIZE * NB_INITIAL_PIECES; k++) {
+      size piece = ONE + k / NB_INITIAL_PIECES;
+      uint64_t square = 1ULL << (line * DIMENSION + columns[k]);
+      b->occ[lane] |= square;
+      b->lo[lane] |= piece & 1 ? square : 0;
+      b->hi[lane] |= piece & 2 ? square : 0;
+      if (out || opt.check)
+        push(t, CALL_PLACE, game_id(w, lane), piece, p, columns[k], OK);
+    }
+  }
+  b->rng[lane] = s | 1;
+}
+
+/* Traduit le dernier appel de la voie en entrées d'enregistrement */
+static void trace_call(worker *w, player before, int lane) {
+  batch *b = w->b;
+  trace *t = &w->traces[lane];
+  int id = game_id(w, lane), arg = b->arg[lane];
+  switch (b->call[lane]) {
+  case CALL_PICK:
+    push(t, before == SOUTH_P ? CALL_SOUTHMOST : CALL_NORTHMOST, id, 0, 0, 0, b->line[lane]);
+    push(t, CALL_PICK, id, before, arg / DIMENSION, arg % DIMENSION, OK);
+    return;
+  case CALL_MOVE:
+  case CALL_SWAP:
+  case CALL_CANCEL_MOVEMENT:
+    for (direction d = GOAL; d <= WEST; d++)
+      push(t, CALL_POSSIBLE, id, d, 0, 0, (b->legal[lane] >> d) & 1);
+    if (b->call[lane] == CALL_MOVE) {
+      push(t, CALL_MOVE, id, arg, 0, 0, OK);
+      if (b->held[lane])
+        push(t, CALL_LEFT, id, 0, 0, 0, b->left[lane]);
+    } else if (b->call[lane] == CALL_SWAP) {
+      push(t, CALL_SWAP, id, arg / DIMENSION, arg % DIMENSION, 0, OK);
+    } else {
+      push(t, CALL_CANCEL_MOVEMENT, id, 0, 0, 0, OK);
+    }
+    return;
+  }
+}
+
+/* Rejoue les entrées sur le moteur lié ; retourne le nombre de divergences */
+static long check_trace(const trace *t) {
+  board g = NULL;
+  long mismatches = 0;
+  for (int i = 0; i < t->count; i++) {
+    const rec_entry *e = &t->entries[i];
+    int got;
+    if (e->op == REC_NEW) {
+      g = new_game();
+      continue;
+    }
+    if (e->op == REC_DESTROY)
+      break;
+    step s = {e->op, e->args[0], e->args[1], e->args[2], 0, 0};
+    got = step_exec(g, &s, NULL);
+    if (got != e->result && mismatches++ == 0) {
+      flockfile(stdout);
+      printf("%s ❌ DIVERGENCE partie %d, appel %d : %s(%d, %d, %d) -> %d attendu, %d obtenu%s\n", RED, e->game, i,
+             rec_op_name(e->op), e->args[0], e->args[1], e->args[2], e->result, got, RESET);
+      funlockfile(stdout);
+    }
+  }
+  destroy_game(g);
+  return mismatches;
+}
+
+/* Fin de partie : résultats, trace, puis partie suivante ou voie au repos */
+static void finish_lane(worker *w, int lane, int *idle) {
+  batch *b = w->b;
+  trace *t = &w->traces[lane];
+  w->games++;
+  w->wins[b->winner[lane]]++;
+  if (b->winner[lane] == NO_PLAYER && b->cancels[lane] >= MAX_CANCELS)
+    w->blocked++;
+  else if (b->winner[lane] == NO_PLAYER)
+    w->draws++;
+  w->turns += b->turns[lane];
+  if (out || opt.check) {
+    int id = game_id(w, lane);
+    push(t, CALL_WINNER, id, 0, 0, 0, b->winner[lane]);
+    push(t, REC_DESTROY, id, 0, 0, 0, 0);
+    if (opt.check)
+      w->mismatches += check_trace(t);
+    if (out) {
+      pthread_mutex_lock(&out_lock);
+      for (int i = 0; i < t->count; i++)
+        rec_write(out, &t->entries[i]);
+      pthread_mutex_unlock(&out_lock);
+    }
+    t->count = 0;
+  }
+  if (__atomic_fetch_add(&started, 1, __ATOMIC_RELAXED) < opt.nb_games)
+    new_lane_game(w, lane);
+  else
+    *idle = 1;
+}
+
+static void *run(void *arg) {
+  worker *w = arg;
+  batch *b = w->b;
+  int tracing = out || opt.check;
+  uint64_t players[LANES]; /* joueur de chaque voie avant le pas, pour les traces */
+  int idle[LANES] = {0}, nb_idle = 0;
+  uint64_t s = opt.seed ^ ((uint64_t)w->index << 32);
+  for (int i = 0; i < LANES; i++) {
+    b->rng[i] = splitmix(&s) | 1;
+    if (__atomic_fetch_add(&started, 1, __ATOMIC_RELAXED) < opt.nb_games) {
+      new_lane_game(w, i);
+    } else {
+      b->done[i] = 1;
+      idle[i] = 1;
+      nb_idle++;
+    }
+  }
+  while (nb_idle < LANES) {
+    if (tracing)
+      memcpy(players, b->player, sizeof(players));
+    opt.advance(b, opt.max_turns, 1);
+    for (int i = 0; i < LANES; i++) {
+      if (idle[i])
+        continue;
+      w->calls++;
+      if (tracing)
+        trace_call(w, players[i], i);
+      if (b->done[i]) {
+        finish_lane(w, i, &idle[i]);
+        nb_idle += idle[i];
+      }
+    }
+  }
+  return NULL;
+}
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void print_rate(const char *label, long count, long total) {
+  double p = total ? (double)count / total : 0;
+  printf("%-22s %10ld  %6.2f %% ± %.2f\n", label, count, 100 * p, total ? 196 * sqrt(p * (1 - p) / total) : 0);
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-n games] [-j threads] [-s seed] [-m max_turns] [-p] [-k avx512|avx2|scalar] [-c] [-o file.rec]\n",
+          prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  int nb_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  const char *kernel_name = NULL, *out_path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      opt.nb_games = atol(argv[++i]);
+    else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      nb_threads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+      opt.seed = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+      opt.max_turns = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-p") == 0)
+      opt.standard = 1;
+    else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+      kernel_name = argv[++i];
+    else if (strcmp(argv[i], "-c") == 0)
+      opt.check = 1;
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      out_path = argv[++i];
+    else
+      usage(argv[0]);
+  }
+  if (nb_threads < 1)
+    nb_threads = 1;
+  opt.advance = find_kernel(&kernel_name);
+  if (opt.advance == NULL) {
+    fprintf(stderr, "%snoyau %s indisponible sur cette machine%s\n", RED, kernel_name, RESET);
+    return 2;
+  }
+  if (out_path) {
+    out = malloc(sizeof(rec_writer));
+    if (rec_open(out, out_path) < 0)
+      return 2;
+  }
+
+  printf("%s=== PLAYOUTS : %ld parties, %d threads, %d voies (%s), placement %s ===%s\n\n", BGBLUE, opt.nb_games,
+         nb_threads, LANES, kernel_name, opt.standard ? "standard" : "aléatoire", RESET);
+  worker *workers = calloc(nb_threads, sizeof(worker));
+  double start = now_s();
+  for (int i = 0; i < nb_threads; i++) {
+    workers[i].index = i;
+    workers[i].b = aligned_alloc(64, sizeof(batch));
+    memset(workers[i].b, 0, sizeof(batch));
+    pthread_create(&workers[i].thread, NULL, run, &workers[i]);
+  }
+  worker total = {0};
+  for (int i = 0; i < nb_threads; i++) {
+    worker *w = &workers[i];
+    pthread_join(w->thread, NULL);
+    total.games += w->games;
+    for (int p = 0; p <= NB_PLAYERS; p++)
+      total.wins[p] += w->wins[p];
+    total.draws += w->draws;
+    total.blocked += w->blocked;
+    total.turns += w->turns;
+    total.calls += w->calls;
+    total.mismatches += w->mismatches;
+    for (int l = 0; l < LANES; l++)
+      free(w->traces[l].entries);
+    free(w->b);
+  }
+  double elapsed = now_s() - start;
+  if (out) {
+    rec_close(out);
+    free(out);
+  }
+
+  print_rate("gains SOUTH_P (1er)", total.wins[SOUTH_P], total.games);
+  print_rate("gains NORTH_P", total.wins[NORTH_P], total.games);
+  char label[64];
+  snprintf(label, sizeof(label), "nulles (%lu tours)", (unsigned long)opt.max_turns);
+  print_rate(label, total.draws, total.games);
+  print_rate("bloquées", total.blocked, total.games);
+  printf("\n%stours par partie : %.1f, appels par tour : %.1f%s\n", BLUE,
+         total.games ? (double)total.turns / total.games : 0, total.turns ? (double)total.calls / total.turns : 0, RESET);
+  printf("%s%.0f parties/s, %.0f appels/s (%.2f s)%s\n", BLUE, total.games / elapsed, total.calls / elapsed, elapsed,
+         RESET);
+  if (out_path)
+    printf("%sTraces : %s (./replay %s)%s\n", BLUE, out_path, out_path, RESET);
+  free(workers);
+  if (opt.check) {
+    if (total.mismatches == 0) {
+      printf("%s 🎉 %ld parties rejouées sur le moteur lié sans divergence %s\n", GREEN, total.games, RESET);
+    } else {
+      printf("%s%ld divergences avec le moteur lié.%s\n", BGRED, total.mismatches, RESET);
+      return 1;
+    }
+  }
+  return 0;
+}
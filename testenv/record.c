@@ -0,0 +1,153 @@
+#define _DEFAULT_SOURCE
+#include "record.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RECORD_VERSION 1
+
+static const signed char nb_args[NB_REC_OPS] = {
+    [CALL_PLACE] = 3, [CALL_PICK] = 3, [CALL_MOVE] = 1, [CALL_SWAP] = 2,
+    [CALL_POSSIBLE] = 1, [CALL_SIZE] = 2, [CALL_AVAILABLE] = 2, [REC_NEXT_PLAYER] = 1,
+};
+
+int rec_nb_args(int op) {
+  return (op >= 0 && op < NB_REC_OPS) ? nb_args[op] : -1;
+}
+
+const char *rec_op_name(int op) {
+  switch (op) {
+  case REC_NEW: return "new_game";
+  case REC_COPY: return "copy_game";
+  case REC_DESTROY: return "destroy_game";
+  case REC_NEXT_PLAYER: return "next_player";
+  default: return call_name(op);
+  }
+}
+
+/* --- ÉCRITURE --- */
+
+int rec_open(rec_writer *w, const char *path) {
+  w->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (w->fd < 0) {
+    perror(path);
+    return -1;
+  }
+  memcpy(w->buf, "GREC", 4);
+  w->buf[4] = RECORD_VERSION;
+  w->buf[5] = DIMENSION;
+  w->len = 6;
+  return 0;
+}
+
+void rec_flush(rec_writer *w) {
+  size_t done = 0;
+  while (done < w->len) {
+    ssize_t n = write(w->fd, w->buf + done, w->len - done);
+    if (n <= 0)
+      break;
+    done += n;
+  }
+  w->len = 0;
+}
+
+static void put_varint(rec_writer *w, int v) {
+  unsigned u = ((unsigned)v << 1) ^ (unsigned)(v >> 31); /* zigzag */
+  while (u >= 0x80) {
+    w->buf[w->len++] = (u & 0x7f) | 0x80;
+    u >>= 7;
+  }
+  w->buf[w->len++] = u;
+}
+
+void rec_write(rec_writer *w, const rec_entry *e) {
+  /* une entrée occupe au plus 1 + 5 × 5 octets */
+  if (w->len + 32 > sizeof(w->buf))
+    rec_flush(w);
+  w->buf[w->len++] = e->op;
+  put_varint(w, e->game);
+  for (int i = 0; i < rec_nb_args(e->op); i++)
+    put_varint(w, e->args[i]);
+  put_varint(w, e->result);
+}
+
+void rec_close(rec_writer *w) {
+  rec_flush(w);
+  close(w->fd);
+  w->fd = -1;
+}
+
+/* --- LECTURE --- */
+
+int rec_map(rec_reader *r, const char *path) {
+  memset(r, 0, sizeof(*r));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    perror(path);
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0 || st.st_size < 6) {
+    fprintf(stderr, "%s: not a record file\n", path);
+    close(fd);
+    return -1;
+  }
+  void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    perror(path);
+    return -1;
+  }
+  r->base = data;
+  r->size = st.st_size;
+  r->end = r->base + r->size;
+  if (memcmp(r->base, "GREC", 4) != 0 || r->base[4] != RECORD_VERSION) {
+    fprintf(stderr, "%s: not a record file (or unsupported version)\n", path);
+    rec_unmap(r);
+    return -1;
+  }
+  if (r->base[5] != DIMENSION) {
+    fprintf(stderr, "%s: recorded with DIMENSION %d, this build uses %d\n", path, r->base[5], DIMENSION);
+    rec_unmap(r);
+    return -1;
+  }
+  r->p = r->base + 6;
+  return 0;
+}
+
+static int get_varint(rec_reader *r, int *v) {
+  unsigned u = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (r->p == r->end)
+      return 0;
+    unsigned char b = *r->p++;
+    u |= (unsigned)(b & 0x7f) << shift;
+    if (!(b & 0x80)) {
+      *v = (int)(u >> 1) ^ -(int)(u & 1);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int rec_next(rec_reader *r, rec_entry *e) {
+  if (r->p == r->end)
+    return 0;
+  e->op = *r->p++;
+  int n = rec_nb_args(e->op);
+  if (n < 0 || !get_varint(r, &e->game))
+    return -1;
+  for (int i = 0; i < n; i++)
+    if (!get_varint(r, &e->args[i]))
+      return -1;
+  return get_varint(r, &e->result) ? 1 : -1;
+}
+
+void rec_unmap(rec_reader *r) {
+  if (r->base)
+    munmap((void *)r->base, r->size);
+  memset(r, 0, sizeof(*r));
+}
@@ -0,0 +1,111 @@
+#ifndef _RECORD_H_
+#define _RECORD_H_
+
+#include "scenario.h"
+#include <stddef.h>
+
+/**
+ * \file record.h
+ *
+ * \brief Enregistrements binaires compacts de suites d'appels à board.h.
+ *
+ * Un enregistrement est une suite d'entrées, chacune décrivant un appel à
+ * l'API, la partie visée et le résultat observé. Les parties sont désignées
+ * par un numéro attribué à leur création (new_game ou copy_game), ce qui
+ * permet de rejouer fidèlement des séquences utilisant plusieurs parties.
+ *
+ * Format : "GREC", un octet de version, un octet ::DIMENSION, puis pour
+ * chaque entrée un octet d'opération suivi d'entiers varint zigzag :
+ * numéro de partie, arguments (selon l'opération), résultat.
+ */
+
+/**
+ * @brief opérations propres aux enregistrements, à la suite des ::call.
+ */
+typedef enum rec_op_e {
+  REC_NEW = NB_CALLS,  /**< new_game(), résultat = numéro de la partie créée */
+  REC_COPY,            /**< copy_game(partie), résultat = numéro de la copie */
+  REC_DESTROY,         /**< destroy_game(partie) */
+  REC_NEXT_PLAYER,     /**< next_player(a) */
+  NB_REC_OPS
+} rec_op;
+
+/**
+ * @brief une entrée d'enregistrement.
+ */
+typedef struct rec_entry_s {
+  int op;        /**< un ::call ou un ::rec_op */
+  int game;      /**< numéro de la partie concernée */
+  int args[3];   /**< arguments, dans l'ordre de l'API */
+  int result;    /**< résultat observé */
+} rec_entry;
+
+/**
+ * @brief écriture tamponnée d'un enregistrement.
+ *
+ * Le tampon est vidé par write(2), ce qui permet de le faire depuis un
+ * gestionnaire de signal.
+ */
+typedef struct rec_writer_s {
+  int fd;
+  size_t len;
+  unsigned char buf[1 << 16];
+} rec_writer;
+
+/**
+ * @brief lecture d'un enregistrement projeté en mémoire.
+ */
+typedef struct rec_reader_s {
+  const unsigned char *base, *p, *end;
+  size_t size;
+} rec_reader;
+
+/**
+ * @brief nombre d'arguments d'une opération.
+ */
+int rec_nb_args(int op);
+
+/**
+ * @brief nom d'une opération (noms des scénarios pour les ::call).
+ */
+const char *rec_op_name(int op);
+
+/**
+ * @brief crée le fichier et écrit l'en-tête.
+ * @return 0 en cas de succès, -1 sinon.
+ */
+int rec_open(rec_writer *w, const char *path);
+
+/**
+ * @brief ajoute une entrée.
+ */
+void rec_write(rec_writer *w, const rec_entry *e);
+
+/**
+ * @brief vide le tampon (utilisable dans un gestionnaire de signal).
+ */
+void rec_flush(rec_writer *w);
+
+/**
+ * @brief vide le tampon et ferme le fichier.
+ */
+void rec_close(rec_writer *w);
+
+/**
+ * @brief projette un enregistrement en mémoire et vérifie l'en-tête.
+ * @return 0 en cas de succès, -1 sinon (le message est déjà affiché).
+ */
+int rec_map(rec_reader *r, const char *path);
+
+/**
+ * @brief lit l'entrée suivante.
+ * @return 1 si une entrée a été lue, 0 en fin de fichier, -1 si le fichier est tronqué.
+ */
+int rec_next(rec_reader *r, rec_entry *e);
+
+/**
+ * @brief libère la projection.
+ */
+void rec_unmap(rec_reader *r);
+
+#endif /*_RECORD_H_*/
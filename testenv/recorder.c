@@ -0,0 +1,342 @@
+#define _DEFAULT_SOURCE
+#include "board.h"
+#include "record.h"
+#include "symmetry.h"
+#include "tracer.h"
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Enregistrement des appels à board.h faits par le programme de test.
+ *
+ * Lié avec -Wl,--wrap=<fonction> pour chaque fonction de board.h (voir
+ * WRAP_FLAGS dans le Makefile) : les appels du programme de test passent par
+ * __wrap_<fonction>, qui appelle le moteur (__real_<fonction>) puis ajoute
+ * l'appel et son résultat à l'enregistrement. Les appels internes du moteur
+ * ne sont pas concernés.
+ *
+ * Chaque appel passe toujours par le traceur (tracer.h) : les derniers appels
+ * sont affichés quand un test échoue, en cas de plantage, et quand le délai
+ * donné par BOARD_TIMEOUT (en secondes) est dépassé.
+ *
+ * L'enregistrement n'a lieu que si la variable BOARD_RECORD donne un fichier.
+ * Le tampon est vidé à la sortie et en cas de plantage.
+ *
+ * Les mêmes enveloppes appliquent la variante symétrique choisie par
+ * BOARD_SYMMETRY (symmetry.h) : arguments transformés avant le moteur,
+ * résultats transformés au retour. L'enregistrement et le traceur
+ * contiennent les appels tels que le moteur les a reçus.
+ */
+
+static rec_writer *writer = NULL;
+
+/* Numéros des parties vivantes */
+#define MAX_GAMES 256
+static board games[MAX_GAMES];
+static int ids[MAX_GAMES];
+static int nb_live = 0, next_id = 0;
+
+static int game_id(board g) {
+  for (int i = 0; i < nb_live; i++)
+    if (games[i] == g)
+      return ids[i];
+  return -1;
+}
+
+static int add_game(board g) {
+  if (g == NULL || nb_live == MAX_GAMES)
+    return -1;
+  games[nb_live] = g;
+  ids[nb_live++] = next_id;
+  return next_id++;
+}
+
+static void remove_game(board g) {
+  for (int i = 0; i < nb_live; i++)
+    if (games[i] == g) {
+      games[i] = games[--nb_live];
+      ids[i] = ids[nb_live];
+      return;
+    }
+}
+
+static void log_call(const trace_entry *t) {
+  rec_entry e = {t->op, t->game, {t->args[0], t->args[1], t->args[2]}, t->result};
+  rec_write(writer, &e);
+}
+
+/* --- PLANTAGES ET DÉLAI --- */
+
+static const int fatal_signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGALRM, SIGTERM, SIGXCPU};
+#define NB_FATAL (int)(sizeof(fatal_signals) / sizeof(fatal_signals[0]))
+static struct sigaction previous[NB_FATAL];
+
+static const char *fatal_title(int sig) {
+  switch (sig) {
+  case SIGSEGV: return "plantage (SIGSEGV)";
+  case SIGBUS: return "plantage (SIGBUS)";
+  case SIGFPE: return "plantage (SIGFPE)";
+  case SIGILL: return "plantage (SIGILL)";
+  case SIGABRT: return "abandon (SIGABRT)";
+  case SIGALRM: return "délai BOARD_TIMEOUT dépassé";
+  case SIGXCPU: return "temps processeur dépassé (SIGXCPU)";
+  default: return "arrêt (SIGTERM)";
+  }
+}
+
+/* Affiche les derniers appels puis rend la main au gestionnaire précédent
+ * (celui par défaut, ou celui d'un sanitizer) */
+static void on_fatal(int sig, siginfo_t *info, void *context) {
+  (void)context;
+  if (writer)
+    rec_flush(writer);
+  trace_dump(STDERR_FILENO, fatal_title(sig));
+  for (int i = 0; i < NB_FATAL; i++)
+    if (fatal_signals[i] == sig)
+      sigaction(sig, &previous[i], NULL);
+  /* faute matérielle : au retour, l'instruction est rejouée et refait la
+     faute sous le gestionnaire précédent ; sinon le signal est renvoyé */
+  int fault = sig == SIGSEGV || sig == SIGBUS || sig == SIGFPE || sig == SIGILL;
+  if (!fault || info->si_code <= 0)
+    raise(sig);
+}
+
+static void on_exit_flush(void) {
+  rec_close(writer);
+}
+
+__attribute__((constructor)) static void recorder_init(void) {
+  /* pile de secours : un moteur en récursion infinie est aussi tracé */
+  static char alt_stack[1 << 16];
+  stack_t current, ss = {alt_stack, 0, sizeof(alt_stack)};
+  if (sigaltstack(NULL, &current) == 0 && (current.ss_flags & SS_DISABLE))
+    sigaltstack(&ss, NULL);
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_sigaction = on_fatal;
+  sa.sa_flags = SA_SIGINFO | SA_ONSTACK;
+  sigemptyset(&sa.sa_mask);
+  for (int i = 0; i < NB_FATAL; i++)
+    sigaction(fatal_signals[i], &sa, &previous[i]);
+
+  const char *timeout = getenv("BOARD_TIMEOUT");
+  if (timeout != NULL && atoi(timeout) > 0)
+    alarm(atoi(timeout));
+
+  const char *path = getenv("BOARD_RECORD");
+  if (path == NULL || *path == '\0')
+    return;
+  static rec_writer w;
+  if (rec_open(&w, path) < 0)
+    return;
+  writer = &w;
+  atexit(on_exit_flush);
+}
+
+/* --- FONCTIONS ENVELOPPÉES --- */
+
+/* Ouvre l'entrée du traceur avant l'appel au moteur */
+#define TRACE(op, g, a, b, c) trace_entry *traced = trace_begin(op, game_id(g), a, b, c)
+
+/* La ferme au retour, et l'enregistre si BOARD_RECORD est donné */
+#define LOG(r)                \
+  do {                        \
+    trace_end(traced, r);     \
+    if (writer)               \
+      log_call(traced);       \
+  } while (0)
+
+player __real_next_player(player current_player);
+player __wrap_next_player(player current_player) {
+  current_player = sym_player(current_player);
+  TRACE(REC_NEXT_PLAYER, NULL, current_player, 0, 0);
+  player r = __real_next_player(current_player);
+  LOG(r);
+  return sym_player(r);
+}
+
+board __real_new_game(void);
+board __wrap_new_game(void) {
+  TRACE(REC_NEW, NULL, 0, 0, 0);
+  board g = __real_new_game();
+  LOG(add_game(g));
+  return g;
+}
+
+board __real_copy_game(board original_game);
+board __wrap_copy_game(board original_game) {
+  TRACE(REC_COPY, original_game, 0, 0, 0);
+  board g = __real_copy_game(original_game);
+  LOG(add_game(g));
+  return g;
+}
+
+void __real_destroy_game(board game);
+void __wrap_destroy_game(board game) {
+  TRACE(REC_DESTROY, game, 0, 0, 0);
+  remove_game(game);
+  __real_destroy_game(game);
+  LOG(0);
+}
+
+size __real_get_piece_size(board game, int line, int column);
+size __wrap_get_piece_size(board game, int line, int column) {
+  line = sym_line(line);
+  column = sym_column(column);
+  TRACE(CALL_SIZE, game, line, column, 0);
+  size r = __real_get_piece_size(game, line, column);
+  LOG(r);
+  return r;
+}
+
+player __real_get_winner(board game);
+player __wrap_get_winner(board game) {
+  TRACE(CALL_WINNER, game, 0, 0, 0);
+  player r = __real_get_winner(game);
+  LOG(r);
+  return sym_player(r);
+}
+
+int __real_southmost_occupied_line(board game);
+int __real_northmost_occupied_line(board game);
+int __wrap_southmost_occupied_line(board game) {
+  if (sym_flipped()) {
+    TRACE(CALL_NORTHMOST, game, 0, 0, 0);
+    int r = __real_northmost_occupied_line(game);
+    LOG(r);
+    return sym_line(r);
+  }
+  TRACE(CALL_SOUTHMOST, game, 0, 0, 0);
+  int r = __real_southmost_occupied_line(game);
+  LOG(r);
+  return r;
+}
+
+int __wrap_northmost_occupied_line(board game) {
+  if (sym_flipped()) {
+    TRACE(CALL_SOUTHMOST, game, 0, 0, 0);
+    int r = __real_southmost_occupied_line(game);
+    LOG(r);
+    return sym_line(r);
+  }
+  TRACE(CALL_NORTHMOST, game, 0, 0, 0);
+  int r = __real_northmost_occupied_line(game);
+  LOG(r);
+  return r;
+}
+
+player __real_picked_piece_owner(board game);
+player __wrap_picked_piece_owner(board game) {
+  TRACE(CALL_OWNER, game, 0, 0, 0);
+  player r = __real_picked_piece_owner(game);
+  LOG(r);
+  return sym_player(r);
+}
+
+size __real_picked_piece_size(board game);
+size __wrap_picked_piece_size(board game) {
+  TRACE(CALL_HELD, game, 0, 0, 0);
+  size r = __real_picked_piece_size(game);
+  LOG(r);
+  return r;
+}
+
+int __real_picked_piece_line(board game);
+int __wrap_picked_piece_line(board game) {
+  TRACE(CALL_LINE, game, 0, 0, 0);
+  int r = __real_picked_piece_line(game);
+  LOG(r);
+  return sym_line(r);
+}
+
+int __real_picked_piece_column(board game);
+int __wrap_picked_piece_column(board game) {
+  TRACE(CALL_COLUMN, game, 0, 0, 0);
+  int r = __real_picked_piece_column(game);
+  LOG(r);
+  return sym_column(r);
+}
+
+int __real_movement_left(board game);
+int __wrap_movement_left(board game) {
+  TRACE(CALL_LEFT, game, 0, 0, 0);
+  int r = __real_movement_left(game);
+  LOG(r);
+  return r;
+}
+
+int __real_nb_pieces_available(board game, size piece, player player);
+int __wrap_nb_pieces_available(board game, size piece, player player) {
+  player = sym_player(player);
+  TRACE(CALL_AVAILABLE, game, piece, player, 0);
+  int r = __real_nb_pieces_available(game, piece, player);
+  LOG(r);
+  return r;
+}
+
+return_code __real_place_piece(board game, size piece, player player, int column);
+return_code __wrap_place_piece(board game, size piece, player player, int column) {
+  player = sym_player(player);
+  column = sym_column(column);
+  TRACE(CALL_PLACE, game, piece, player, column);
+  return_code r = __real_place_piece(game, piece, player, column);
+  LOG(r);
+  return r;
+}
+
+return_code __real_pick_piece(board game, player current_player, int line, int column);
+return_code __wrap_pick_piece(board game, player current_player, int line, int column) {
+  current_player = sym_player(current_player);
+  line = sym_line(line);
+  column = sym_column(column);
+  TRACE(CALL_PICK, game, current_player, line, column);
+  return_code r = __real_pick_piece(game, current_player, line, column);
+  LOG(r);
+  return r;
+}
+
+bool __real_is_move_possible(board game, direction direction);
+bool __wrap_is_move_possible(board game, direction direction) {
+  direction = sym_direction(direction);
+  TRACE(CALL_POSSIBLE, game, direction, 0, 0);
+  bool r = __real_is_move_possible(game, direction);
+  LOG(r);
+  return r;
+}
+
+return_code __real_move_piece(board game, direction direction);
+return_code __wrap_move_piece(board game, direction direction) {
+  direction = sym_direction(direction);
+  TRACE(CALL_MOVE, game, direction, 0, 0);
+  return_code r = __real_move_piece(game, direction);
+  LOG(r);
+  return r;
+}
+
+return_code __real_swap_piece(board game, int target_line, int target_column);
+return_code __wrap_swap_piece(board game, int target_line, int target_column) {
+  target_line = sym_line(target_line);
+  target_column = sym_column(target_column);
+  TRACE(CALL_SWAP, game, target_line, target_column, 0);
+  return_code r = __real_swap_piece(game, target_line, target_column);
+  LOG(r);
+  return r;
+}
+
+return_code __real_cancel_movement(board game);
+return_code __wrap_cancel_movement(board game) {
+  TRACE(CALL_CANCEL_MOVEMENT, game, 0, 0, 0);
+  return_code r = __real_cancel_movement(game);
+  LOG(r);
+  return r;
+}
+
+return_code __real_cancel_step(board game);
+return_code __wrap_cancel_step(board game) {
+  TRACE(CALL_CANCEL_STEP, game, 0, 0, 0);
+  return_code r = __real_cancel_step(game);
+  LOG(r);
+  return r;
+}
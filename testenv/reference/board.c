@@ -0,0 +1,310 @@
+#include "board.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Moteur de référence : implémentation directe des règles de board.h.
+ *
+ * Le moteur ne suit pas le tour de jeu : c'est à l'appelant d'alterner
+ * les joueurs (pick_piece reçoit le joueur courant).
+ */
+
+#define MAX_STEPS (4 * DIMENSION * DIMENSION)
+
+/* Un pas du mouvement en cours, pour cancel_step */
+typedef struct step_s {
+  int line, column, left;
+} step;
+
+struct board_s {
+  size squares[DIMENSION][DIMENSION];
+  int occupied[DIMENSION]; /* pièces par ligne : southmost et northmost en O(DIMENSION) */
+  int placed[NB_PLAYERS + 1][NB_SIZE + 1];
+  int nb_placed;
+  player winner;
+  /* mouvement en cours */
+  player owner;
+  size held;
+  int line, column, left;
+  int nb_steps;
+  step steps[MAX_STEPS];
+  /* arêtes déjà parcourues : [ligne][colonne][0 = vers le nord, 1 = vers l'est] */
+  unsigned char used[DIMENSION][DIMENSION][2];
+};
+
+player next_player(player current_player) {
+  if (current_player == SOUTH_P)
+    return NORTH_P;
+  if (current_player == NORTH_P)
+    return SOUTH_P;
+  return NO_PLAYER;
+}
+
+board new_game() {
+  board g = calloc(1, sizeof(struct board_s));
+  if (g == NULL)
+    return NULL;
+  g->line = g->column = g->left = -1;
+  return g;
+}
+
+board copy_game(board original_game) {
+  if (original_game == NULL)
+    return NULL;
+  board g = malloc(sizeof(struct board_s));
+  if (g != NULL)
+    memcpy(g, original_game, sizeof(struct board_s));
+  return g;
+}
+
+void destroy_game(board game) {
+  free(game);
+}
+
+static bool on_board(int line, int column) {
+  return line >= 0 && line < DIMENSION && column >= 0 && column < DIMENSION;
+}
+
+static bool valid_player(player p) {
+  return p == SOUTH_P || p == NORTH_P;
+}
+
+static bool valid_size(size s) {
+  return s >= ONE && s <= THREE;
+}
+
+static void set_square(board game, int line, int column, size s) {
+  game->occupied[line] += (s != NONE) - (game->squares[line][column] != NONE);
+  game->squares[line][column] = s;
+}
+
+static bool setup_over(board game) {
+  return game->nb_placed == NB_PLAYERS * NB_SIZE * NB_INITIAL_PIECES;
+}
+
+size get_piece_size(board game, int line, int column) {
+  if (game == NULL || !on_board(line, column))
+    return NONE;
+  return game->squares[line][column];
+}
+
+player get_winner(board game) {
+  return game == NULL ? NO_PLAYER : game->winner;
+}
+
+int southmost_occupied_line(board game) {
+  if (game == NULL)
+    return -1;
+  for (int l = 0; l < DIMENSION; l++)
+    if (game->occupied[l])
+      return l;
+  return -1;
+}
+
+int northmost_occupied_line(board game) {
+  if (game == NULL)
+    return -1;
+  for (int l = DIMENSION - 1; l >= 0; l--)
+    if (game->occupied[l])
+      return l;
+  return -1;
+}
+
+player picked_piece_owner(board game) {
+  return game == NULL ? NO_PLAYER : game->owner;
+}
+
+size picked_piece_size(board game) {
+  return game == NULL || game->owner == NO_PLAYER ? NONE : game->held;
+}
+
+int picked_piece_line(board game) {
+  return game == NULL || game->owner == NO_PLAYER ? -1 : game->line;
+}
+
+int picked_piece_column(board game) {
+  return game == NULL || game->owner == NO_PLAYER ? -1 : game->column;
+}
+
+int movement_left(board game) {
+  return game == NULL || game->owner == NO_PLAYER ? -1 : game->left;
+}
+
+int nb_pieces_available(board game, size piece, player player) {
+  if (game == NULL || !valid_size(piece) || !valid_player(player))
+    return -1;
+  return NB_INITIAL_PIECES - game->placed[player][piece];
+}
+
+return_code place_piece(board game, size piece, player player, int column) {
+  if (game == NULL || !valid_size(piece) || !valid_player(player) || column < 0 || column >= DIMENSION)
+    return PARAM;
+  int line = player == SOUTH_P ? 0 : DIMENSION - 1;
+  if (game->squares[line][column] != NONE)
+    return EMPTY;
+  if (game->placed[player][piece] >= NB_INITIAL_PIECES)
+    return FORBIDDEN;
+  set_square(game, line, column, piece);
+  game->placed[player][piece]++;
+  game->nb_placed++;
+  return OK;
+}
+
+return_code pick_piece(board game, player current_player, int line, int column) {
+  if (game == NULL)
+    return PARAM;
+  if (!setup_over(game) || game->winner != NO_PLAYER || game->owner != NO_PLAYER)
+    return FORBIDDEN;
+  if (!valid_player(current_player) || !on_board(line, column))
+    return PARAM;
+  if (game->squares[line][column] == NONE)
+    return EMPTY;
+  int expected = current_player == SOUTH_P ? southmost_occupied_line(game) : northmost_occupied_line(game);
+  if (line != expected)
+    return FORBIDDEN;
+  game->owner = current_player;
+  game->held = game->squares[line][column];
+  set_square(game, line, column, NONE);
+  game->line = line;
+  game->column = column;
+  game->left = game->held;
+  game->nb_steps = 0;
+  memset(game->used, 0, sizeof(game->used));
+  return OK;
+}
+
+static void target(int line, int column, direction d, int *tl, int *tc) {
+  *tl = line + (d == NORTH) - (d == SOUTH);
+  *tc = column + (d == EAST) - (d == WEST);
+}
+
+static unsigned char *edge(board game, int l1, int c1, int l2, int c2) {
+  if (l1 > l2 || c1 > c2)
+    return edge(game, l2, c2, l1, c1);
+  return &game->used[l1][c1][l1 == l2];
+}
+
+/* Pas restants effectifs : sur une pièce, le prochain pas est un rebond */
+static int effective_left(board game) {
+  return game->left == 0 ? (int)game->squares[game->line][game->column] : game->left;
+}
+
+static bool goal_line(board game) {
+  return (game->owner == SOUTH_P && game->line == DIMENSION - 1) ||
+         (game->owner == NORTH_P && game->line == 0);
+}
+
+bool is_move_possible(board game, direction direction) {
+  if (game == NULL || game->owner == NO_PLAYER)
+    return false;
+  int left = effective_left(game);
+  if (direction == GOAL)
+    return left == 1 && goal_line(game);
+  if (direction < SOUTH || direction > WEST)
+    return false;
+  int tl, tc;
+  target(game->line, game->column, direction, &tl, &tc);
+  if (!on_board(tl, tc) || *edge(game, game->line, game->column, tl, tc))
+    return false;
+  return game->squares[tl][tc] == NONE || left == 1;
+}
+
+static void finish_turn(board game) {
+  game->owner = NO_PLAYER;
+  game->held = NONE;
+  game->line = game->column = game->left = -1;
+  game->nb_steps = 0;
+}
+
+return_code move_piece(board game, direction direction) {
+  if (game == NULL || game->owner == NO_PLAYER)
+    return EMPTY;
+  if (direction < GOAL || direction > WEST)
+    return PARAM;
+  int tl = -1, tc = -1;
+  if (direction != GOAL) {
+    target(game->line, game->column, direction, &tl, &tc);
+    if (!on_board(tl, tc))
+      return PARAM;
+  }
+  if (!is_move_possible(game, direction))
+    return FORBIDDEN;
+  if (game->nb_steps == MAX_STEPS)
+    return FORBIDDEN;
+
+  game->steps[game->nb_steps++] = (step){game->line, game->column, game->left};
+  int left = effective_left(game) - 1;
+  if (direction == GOAL) {
+    game->winner = game->owner;
+    finish_turn(game);
+    return OK;
+  }
+  *edge(game, game->line, game->column, tl, tc) = 1;
+  game->line = tl;
+  game->column = tc;
+  game->left = left;
+  if (left == 0 && game->squares[tl][tc] == NONE) {
+    set_square(game, tl, tc, game->held);
+    finish_turn(game);
+  }
+  return OK;
+}
+
+return_code swap_piece(board game, int target_line, int target_column) {
+  if (game == NULL || game->owner == NO_PLAYER || game->left != 0)
+    return EMPTY;
+  if (!on_board(target_line, target_column))
+    return PARAM;
+  if (game->squares[target_line][target_column] != NONE ||
+      (target_line == game->line && target_column == game->column))
+    return FORBIDDEN;
+  set_square(game, target_line, target_column, game->squares[game->line][game->column]);
+  set_square(game, game->line, game->column, game->held);
+  finish_turn(game);
+  return OK;
+}
+
+return_code cancel_movement(board game) {
+  if (game == NULL || game->owner == NO_PLAYER)
+    return EMPTY;
+  if (game->nb_steps > 0) {
+    game->line = game->steps[0].line;
+    game->column = game->steps[0].column;
+  }
+  set_square(game, game->line, game->column, game->held);
+  finish_turn(game);
+  return OK;
+}
+
+return_code cancel_step(board game) {
+  if (game == NULL || game->owner == NO_PLAYER)
+    return EMPTY;
+  if (game->nb_steps == 0)
+    return cancel_movement(game);
+  step s = game->steps[--game->nb_steps];
+  *edge(game, s.line, s.column, game->line, game->column) = 0;
+  game->line = s.line;
+  game->column = s.column;
+  game->left = s.left;
+  return OK;
+}
+
+/*
+ * Hors de board.h : partie au placement terminé, avec les pièces données
+ * (grid[ligne][colonne]), pour les outils qui parcourent toutes les positions
+ * (testenv/tablebase.c, par dlsym). Le nombre de pièces de chaque taille
+ * n'est pas vérifié.
+ */
+board position_game(const size grid[DIMENSION][DIMENSION]) {
+  board g = new_game();
+  if (g == NULL)
+    return NULL;
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++)
+      set_square(g, l, c, grid[l][c]);
+  for (player p = SOUTH_P; p <= NORTH_P; p++)
+    for (size s = ONE; s <= THREE; s++)
+      g->placed[p][s] = NB_INITIAL_PIECES;
+  g->nb_placed = NB_PLAYERS * NB_SIZE * NB_INITIAL_PIECES;
+  return g;
+}
@@ -0,0 +1,166 @@
+#define _POSIX_C_SOURCE 199309L
+#include "board.h"
+#include "record.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGRED "\033[101m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Rejoue un enregistrement (record.h) sur le moteur lié et compare chaque
+ * résultat à celui qui a été enregistré.
+ *   ./replay [-p] [-m max] [-r N] fichier.rec
+ *   -p   affiche l'enregistrement sous forme lisible, sans le rejouer
+ *   -m   nombre maximal de divergences affichées (10 par défaut)
+ *   -r   rejoue N fois (mesure de débit)
+ */
+
+static board *games = NULL;
+static int nb_games = 0;
+
+static void set_game(int id, board g) {
+  if (id < 0)
+    return;
+  if (id >= nb_games) {
+    int n = nb_games ? nb_games : 64;
+    while (n <= id)
+      n *= 2;
+    games = realloc(games, n * sizeof(board));
+    memset(games + nb_games, 0, (n - nb_games) * sizeof(board));
+    nb_games = n;
+  }
+  games[id] = g;
+}
+
+static board get_game(int id) {
+  return (id >= 0 && id < nb_games) ? games[id] : NULL;
+}
+
+static void print_entry(long index, const rec_entry *e) {
+  printf("%8ld  g%-3d %-12s", index, e->game, rec_op_name(e->op));
+  for (int i = 0; i < rec_nb_args(e->op); i++)
+    printf(" %d", e->args[i]);
+  printf(" -> %d\n", e->result);
+}
+
+/* Exécute une entrée, retourne le résultat obtenu */
+static int execute(const rec_entry *e) {
+  switch (e->op) {
+  case REC_NEW: {
+    board g = new_game();
+    set_game(e->result, g);
+    return g != NULL ? e->result : -1;
+  }
+  case REC_COPY: {
+    board g = copy_game(get_game(e->game));
+    set_game(e->result, g);
+    return g != NULL ? e->result : -1;
+  }
+  case REC_DESTROY:
+    destroy_game(get_game(e->game));
+    set_game(e->game, NULL);
+    return e->result;
+  case REC_NEXT_PLAYER:
+    return next_player(e->args[0]);
+  default: {
+    board g = get_game(e->game);
+    if (g == NULL)
+      return e->result; /* partie non créée lors de l'enregistrement */
+    step s = {e->op, e->args[0], e->args[1], e->args[2], 0, 0};
+    return step_exec(g, &s, NULL);
+  }
+  }
+}
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-p] [-m max_mismatches] [-r repeat] file.rec\n", prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  int print = 0, max_shown = 10, repeat = 1;
+  const char *path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-p") == 0)
+      print = 1;
+    else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+      max_shown = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+      repeat = atoi(argv[++i]);
+    else if (argv[i][0] != '-' && path == NULL)
+      path = argv[i];
+    else
+      usage(argv[0]);
+  }
+  if (path == NULL)
+    usage(argv[0]);
+
+  rec_reader r;
+  if (rec_map(&r, path) < 0)
+    return 2;
+
+  rec_entry e;
+  long index = 0, mismatches = 0;
+  int status = 0;
+  if (print) {
+    while ((status = rec_next(&r, &e)) == 1)
+      print_entry(index++, &e);
+    if (status < 0)
+      printf("%s(enregistrement tronqué)%s\n", RED, RESET);
+    rec_unmap(&r);
+    return 0;
+  }
+
+  printf("%s=== REJEU : %s ===%s\n\n", BGBLUE, path, RESET);
+  double start = now_s();
+  for (int rep = 0; rep < repeat; rep++) {
+    r.p = r.base + 6;
+    index = 0;
+    while ((status = rec_next(&r, &e)) == 1) {
+      int got = execute(&e);
+      if (got != e.result && rep == 0) {
+        if (++mismatches <= max_shown) {
+          printf("%s ❌ DIVERGENCE à l'appel %ld%s\n", RED, index, RESET);
+          printf("%s", RED);
+          print_entry(index, &e);
+          printf("      -> Got: %d%s\n\n", got, RESET);
+        }
+      }
+      index++;
+    }
+    /* parties laissées ouvertes par l'enregistrement */
+    for (int i = 0; i < nb_games; i++)
+      if (games[i] != NULL) {
+        destroy_game(games[i]);
+        games[i] = NULL;
+      }
+  }
+  double elapsed = now_s() - start;
+
+  if (status < 0)
+    printf("%sEnregistrement tronqué après %ld appels.%s\n", RED, index, RESET);
+  if (mismatches == 0)
+    printf("%s 🎉 %ld appels rejoués sans divergence %s\n", GREEN, index, RESET);
+  else
+    printf("%s%ld divergences sur %ld appels.%s\n", BGRED, mismatches, index, RESET);
+  if (elapsed > 0)
+    printf("%s%.0f appels/s%s\n", BLUE, index * (double)repeat / elapsed, RESET);
+
+  free(games);
+  rec_unmap(&r);
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+#define _POSIX_C_SOURCE 199309L
+#include "board.h"
+#include "scenario.h"
+#include "tracer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGRED "\033[101m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Interpréteur de scénarios : ./scenarios [-q] [-r N] fichier.scn...
+ *   -q   n'affiche que les échecs
+ *   -r N exécute N fois l'ensemble (mesure de débit)
+ */
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-q] [-r repeat] file.scn...\n", prog);
+  exit(2);
+}
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char **argv) {
+  int quiet = 0, repeat = 1;
+  scenario_set set;
+  memset(&set, 0, sizeof(set));
+
+  int i;
+  for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+    if (strcmp(argv[i], "-q") == 0)
+      quiet = 1;
+    else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+      repeat = atoi(argv[++i]);
+    else
+      usage(argv[0]);
+  }
+  if (i == argc)
+    usage(argv[0]);
+  for (; i < argc; i++)
+    if (scenario_load(&set, argv[i]) < 0)
+      return 2;
+
+  printf("%s=== SCÉNARIOS (%d) ===%s\n\n", BGBLUE, set.nb_scenarios, RESET);
+
+  /* noms des scénarios pour le traceur, préparés hors de la boucle mesurée */
+  char (*labels)[64] = malloc(set.nb_scenarios * sizeof(*labels));
+  for (int k = 0; k < set.nb_scenarios; k++)
+    snprintf(labels[k], sizeof(labels[k]), "%.*s", set.scenarios[k].name_len, set.scenarios[k].name);
+
+  int failed = 0;
+  double start = now_ms();
+  for (int r = 0; r < repeat; r++) {
+    for (int k = 0; k < set.nb_scenarios; k++) {
+      const scenario *sc = &set.scenarios[k];
+      int bad, got;
+      trace_reset(labels[k]);
+      int ok = scenario_run(&set, sc, &bad, &got);
+      if (r > 0)
+        continue;
+      if (ok) {
+        if (!quiet)
+          printf("%s ✅ PASS: %.*s%s\n", GREEN, sc->name_len, sc->name, RESET);
+        continue;
+      }
+      failed++;
+      printf("%s ❌ FAIL: %.*s%s\n", RED, sc->name_len, sc->name, RESET);
+      if (bad < 0) {
+        printf("%s      -> new_game returned NULL%s\n\n", RED, RESET);
+        continue;
+      }
+      const step *s = &set.steps[bad];
+      printf("%s      -> line %d, '%s': expected %d, got %d%s\n\n",
+             RED, s->line, call_name(s->call), s->expected, got, RESET);
+      fflush(stdout);
+      trace_dump(STDOUT_FILENO, "échec");
+    }
+  }
+  double elapsed = now_ms() - start;
+
+  printf("\n%s%d/%d scénarios passés.%s\n", bgyellow, set.nb_scenarios - failed, set.nb_scenarios, RESET);
+  if (failed > 0)
+    printf("%s%d scénarios échoués.%s\n", BGRED, failed, RESET);
+  if (elapsed > 0)
+    printf("%s%d exécutions en %.3f ms (%.0f scénarios/ms)%s\n", BLUE,
+           set.nb_scenarios * repeat, elapsed, set.nb_scenarios * repeat / elapsed, RESET);
+
+  free(labels);
+  scenario_free(&set);
+  return failed ? 1 : 0;
+}
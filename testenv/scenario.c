@@ -0,0 +1,367 @@
+#define _DEFAULT_SOURCE
+#include "scenario.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char *call_names[NB_CALLS] = {
+    "place", "pick", "move", "swap", "cancel", "step", "possible", "size", "winner",
+    "south", "north", "owner", "held", "line", "column", "left", "available", "board"};
+
+const char *call_name(call c) {
+  return (c >= 0 && c < NB_CALLS) ? call_names[c] : "?";
+}
+
+/* --- LECTURE DES JETONS --- */
+
+typedef struct cursor_s {
+  const char *p, *end;
+  const char *path;
+  int line;
+} cursor;
+
+static void skip_blanks(cursor *cur) {
+  while (cur->p < cur->end && (*cur->p == ' ' || *cur->p == '\t' || *cur->p == '\r'))
+    cur->p++;
+  if (cur->p < cur->end && *cur->p == '#')
+    while (cur->p < cur->end && *cur->p != '\n')
+      cur->p++;
+}
+
+/* Jeton suivant sur la ligne courante, longueur 0 en fin de ligne */
+static int next_token(cursor *cur, const char **tok) {
+  skip_blanks(cur);
+  *tok = cur->p;
+  while (cur->p < cur->end && *cur->p != ' ' && *cur->p != '\t' && *cur->p != '\r' &&
+         *cur->p != '\n' && *cur->p != '#')
+    cur->p++;
+  return (int)(cur->p - *tok);
+}
+
+static void next_line(cursor *cur) {
+  while (cur->p < cur->end && *cur->p != '\n')
+    cur->p++;
+  if (cur->p < cur->end)
+    cur->p++;
+  cur->line++;
+}
+
+static int token_is(const char *tok, int len, const char *word) {
+  return (int)strlen(word) == len && strncmp(tok, word, len) == 0;
+}
+
+static int parse_int(const char *tok, int len, int *out) {
+  int sign = 1, i = 0, v = 0;
+  if (len > 0 && tok[0] == '-') {
+    sign = -1;
+    i = 1;
+  }
+  if (i == len)
+    return 0;
+  for (; i < len; i++) {
+    if (tok[i] < '0' || tok[i] > '9' || v > SHRT_MAX)
+      return 0;
+    v = v * 10 + (tok[i] - '0');
+  }
+  *out = sign * v;
+  return 1;
+}
+
+typedef enum kind_e { K_INT, K_CODE, K_PLAYER, K_SIZE, K_DIR, K_BOOL } kind;
+
+static int parse_value(const char *tok, int len, kind k, int *out) {
+  if (len == 1 && tok[0] == '*' && k == K_CODE) {
+    *out = ANY_RESULT;
+    return 1;
+  }
+  switch (k) {
+  case K_CODE:
+    if (token_is(tok, len, "OK")) { *out = OK; return 1; }
+    if (token_is(tok, len, "EMPTY")) { *out = EMPTY; return 1; }
+    if (token_is(tok, len, "FORBIDDEN")) { *out = FORBIDDEN; return 1; }
+    if (token_is(tok, len, "PARAM")) { *out = PARAM; return 1; }
+    break;
+  case K_PLAYER:
+    if (token_is(tok, len, "S")) { *out = SOUTH_P; return 1; }
+    if (token_is(tok, len, "N")) { *out = NORTH_P; return 1; }
+    if (token_is(tok, len, "-")) { *out = NO_PLAYER; return 1; }
+    break;
+  case K_SIZE:
+    if (token_is(tok, len, "-")) { *out = NONE; return 1; }
+    break;
+  case K_DIR:
+    if (token_is(tok, len, "G")) { *out = GOAL; return 1; }
+    if (token_is(tok, len, "S")) { *out = SOUTH; return 1; }
+    if (token_is(tok, len, "N")) { *out = NORTH; return 1; }
+    if (token_is(tok, len, "E")) { *out = EAST; return 1; }
+    if (token_is(tok, len, "W")) { *out = WEST; return 1; }
+    break;
+  default:
+    break;
+  }
+  return parse_int(tok, len, out);
+}
+
+/* --- CONSTRUCTION DE L'ENSEMBLE --- */
+
+static void *grow(void *ptr, int *cap, int need, size_t elem) {
+  if (need <= *cap)
+    return ptr;
+  int ncap = *cap ? *cap * 2 : 64;
+  while (ncap < need)
+    ncap *= 2;
+  void *n = realloc(ptr, ncap * elem);
+  if (n == NULL) {
+    perror("realloc");
+    exit(2);
+  }
+  *cap = ncap;
+  return n;
+}
+
+static step *push_step(scenario_set *set, int call, int a, int b, int c, int expected, int line) {
+  set->steps = grow(set->steps, &set->cap_steps, set->nb_steps + 1, sizeof(step));
+  step *s = &set->steps[set->nb_steps++];
+  s->call = call;
+  s->a = a;
+  s->b = b;
+  s->c = c;
+  s->expected = expected;
+  s->line = line;
+  return s;
+}
+
+/* Arguments et résultat attendu de chaque instruction */
+static const struct {
+  int nb_args;
+  kind args[3];
+  kind result;
+} signatures[NB_CALLS] = {
+    [CALL_PLACE] = {3, {K_SIZE, K_PLAYER, K_INT}, K_CODE},
+    [CALL_PICK] = {3, {K_PLAYER, K_INT, K_INT}, K_CODE},
+    [CALL_MOVE] = {1, {K_DIR}, K_CODE},
+    [CALL_SWAP] = {2, {K_INT, K_INT}, K_CODE},
+    [CALL_CANCEL_MOVEMENT] = {0, {0}, K_CODE},
+    [CALL_CANCEL_STEP] = {0, {0}, K_CODE},
+    [CALL_POSSIBLE] = {1, {K_DIR}, K_BOOL},
+    [CALL_SIZE] = {2, {K_INT, K_INT}, K_SIZE},
+    [CALL_WINNER] = {0, {0}, K_PLAYER},
+    [CALL_SOUTHMOST] = {0, {0}, K_INT},
+    [CALL_NORTHMOST] = {0, {0}, K_INT},
+    [CALL_OWNER] = {0, {0}, K_PLAYER},
+    [CALL_HELD] = {0, {0}, K_SIZE},
+    [CALL_LINE] = {0, {0}, K_INT},
+    [CALL_COLUMN] = {0, {0}, K_INT},
+    [CALL_LEFT] = {0, {0}, K_INT},
+    [CALL_AVAILABLE] = {2, {K_SIZE, K_PLAYER}, K_INT},
+    [CALL_BOARD] = {0, {0}, K_INT},
+};
+
+static int syntax_error(cursor *cur, const char *msg) {
+  fprintf(stderr, "%s:%d: %s\n", cur->path, cur->line, msg);
+  return -1;
+}
+
+static int parse_board(scenario_set *set, cursor *cur) {
+  set->grids = grow(set->grids, &set->cap_grids, set->nb_grids + 1, sizeof(*set->grids));
+  int g = set->nb_grids++;
+  int start = cur->line;
+  for (int l = DIMENSION - 1; l >= 0; l--) {
+    next_line(cur);
+    const char *tok;
+    int len = next_token(cur, &tok);
+    if (len != DIMENSION)
+      return syntax_error(cur, "board: each row needs DIMENSION squares");
+    for (int c = 0; c < DIMENSION; c++) {
+      if (tok[c] == '.')
+        set->grids[g][l][c] = NONE;
+      else if (tok[c] >= '1' && tok[c] <= '3')
+        set->grids[g][l][c] = tok[c] - '0';
+      else
+        return syntax_error(cur, "board: squares are '.', '1', '2' or '3'");
+    }
+  }
+  push_step(set, CALL_BOARD, (signed char)(g & 0xff), (signed char)(g >> 8), 0, 1, start);
+  return 0;
+}
+
+static int parse_file(scenario_set *set, cursor *cur) {
+  scenario *current = NULL;
+  for (; cur->p < cur->end; next_line(cur)) {
+    const char *tok;
+    int len = next_token(cur, &tok);
+    if (len == 0)
+      continue;
+
+    if (token_is(tok, len, "scenario")) {
+      if (current != NULL)
+        return syntax_error(cur, "missing 'end' before new scenario");
+      len = next_token(cur, &tok);
+      if (len == 0)
+        return syntax_error(cur, "scenario needs a name");
+      set->scenarios = grow(set->scenarios, &set->cap_scenarios, set->nb_scenarios + 1, sizeof(scenario));
+      current = &set->scenarios[set->nb_scenarios++];
+      current->name = tok;
+      current->name_len = len;
+      current->first = set->nb_steps;
+      current->nb_steps = 0;
+      continue;
+    }
+    if (current == NULL)
+      return syntax_error(cur, "instruction outside of a scenario");
+
+    if (token_is(tok, len, "end")) {
+      current->nb_steps = set->nb_steps - current->first;
+      current = NULL;
+      continue;
+    }
+    if (token_is(tok, len, "setup")) {
+      int p, s;
+      len = next_token(cur, &tok);
+      if (!parse_value(tok, len, K_PLAYER, &p))
+        return syntax_error(cur, "setup: expected S or N");
+      for (int c = 0; c < DIMENSION; c++) {
+        len = next_token(cur, &tok);
+        if (!parse_value(tok, len, K_SIZE, &s))
+          return syntax_error(cur, "setup: expected one size per column");
+        if (s != NONE)
+          push_step(set, CALL_PLACE, s, p, c, OK, cur->line);
+      }
+      continue;
+    }
+    if (token_is(tok, len, "board")) {
+      if (parse_board(set, cur) < 0)
+        return -1;
+      continue;
+    }
+
+    int k;
+    for (k = 0; k < NB_CALLS; k++)
+      if (token_is(tok, len, call_names[k]))
+        break;
+    if (k == NB_CALLS || k == CALL_BOARD)
+      return syntax_error(cur, "unknown instruction");
+
+    int args[3] = {0, 0, 0}, expected;
+    for (int i = 0; i < signatures[k].nb_args; i++) {
+      len = next_token(cur, &tok);
+      if (!parse_value(tok, len, signatures[k].args[i], &args[i]))
+        return syntax_error(cur, "invalid argument");
+      /* les arguments sont rangés sur un octet signé (step) */
+      if (args[i] < SCHAR_MIN || args[i] > SCHAR_MAX)
+        return syntax_error(cur, "argument out of range");
+    }
+    len = next_token(cur, &tok);
+    if (!parse_value(tok, len, signatures[k].result, &expected))
+      return syntax_error(cur, "invalid or missing expected result");
+    if ((expected == ANY_RESULT && !(len == 1 && tok[0] == '*')) || expected < SHRT_MIN || expected > SHRT_MAX)
+      return syntax_error(cur, "expected result out of range");
+    push_step(set, k, args[0], args[1], args[2], expected, cur->line);
+  }
+  if (current != NULL)
+    return syntax_error(cur, "missing 'end' at end of file");
+  return 0;
+}
+
+int scenario_load(scenario_set *set, const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    perror(path);
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    perror(path);
+    close(fd);
+    return -1;
+  }
+  if (st.st_size == 0) {
+    close(fd);
+    return 0;
+  }
+  /* Le fichier reste projeté : les noms des scénarios pointent dedans */
+  const char *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    perror(path);
+    return -1;
+  }
+  set->files = grow(set->files, &set->cap_files, set->nb_files + 1, sizeof(*set->files));
+  set->files[set->nb_files].addr = (void *)data;
+  set->files[set->nb_files++].len = st.st_size;
+  cursor cur = {data, data + st.st_size, path, 1};
+  return parse_file(set, &cur);
+}
+
+void scenario_free(scenario_set *set) {
+  for (int i = 0; i < set->nb_files; i++)
+    munmap(set->files[i].addr, set->files[i].len);
+  free(set->files);
+  free(set->scenarios);
+  free(set->steps);
+  free(set->grids);
+  memset(set, 0, sizeof(*set));
+}
+
+/* --- INTERPRÉTEUR --- */
+
+/* L'indice de grille est réparti sur a (poids faible) et b (poids fort) */
+#define GRID_INDEX(s) ((unsigned char)(s)->a | (unsigned char)(s)->b << 8)
+
+static int board_matches(board game, signed char grid[DIMENSION][DIMENSION]) {
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++)
+      if ((int)get_piece_size(game, l, c) != grid[l][c])
+        return 0;
+  return 1;
+}
+
+int step_exec(board game, const step *s, const scenario_set *set) {
+  switch (s->call) {
+  case CALL_PLACE: return place_piece(game, s->a, s->b, s->c);
+  case CALL_PICK: return pick_piece(game, s->a, s->b, s->c);
+  case CALL_MOVE: return move_piece(game, s->a);
+  case CALL_SWAP: return swap_piece(game, s->a, s->b);
+  case CALL_CANCEL_MOVEMENT: return cancel_movement(game);
+  case CALL_CANCEL_STEP: return cancel_step(game);
+  case CALL_POSSIBLE: return is_move_possible(game, s->a) ? 1 : 0;
+  case CALL_SIZE: return get_piece_size(game, s->a, s->b);
+  case CALL_WINNER: return get_winner(game);
+  case CALL_SOUTHMOST: return southmost_occupied_line(game);
+  case CALL_NORTHMOST: return northmost_occupied_line(game);
+  case CALL_OWNER: return picked_piece_owner(game);
+  case CALL_HELD: return picked_piece_size(game);
+  case CALL_LINE: return picked_piece_line(game);
+  case CALL_COLUMN: return picked_piece_column(game);
+  case CALL_LEFT: return movement_left(game);
+  case CALL_AVAILABLE: return nb_pieces_available(game, s->a, s->b);
+  case CALL_BOARD: return set ? board_matches(game, set->grids[GRID_INDEX(s)]) : 1;
+  }
+  return ANY_RESULT;
+}
+
+int scenario_run(const scenario_set *set, const scenario *sc, int *failed_step, int *got) {
+  board g = new_game();
+  *failed_step = -1;
+  if (g == NULL) {
+    *got = 0;
+    return 0;
+  }
+  for (int i = sc->first; i < sc->first + sc->nb_steps; i++) {
+    const step *s = &set->steps[i];
+    int r = step_exec(g, s, set);
+    if (s->expected != ANY_RESULT && r != s->expected) {
+      *failed_step = i;
+      *got = r;
+      destroy_game(g);
+      return 0;
+    }
+  }
+  destroy_game(g);
+  return 1;
+}
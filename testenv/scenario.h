@@ -0,0 +1,144 @@
+#ifndef _SCENARIO_H_
+#define _SCENARIO_H_
+
+#include "board.h"
+#include <stddef.h>
+
+/**
+ * \file scenario.h
+ *
+ * \brief Scénarios déclaratifs pour tester un moteur board.h sans recompiler.
+ *
+ * Un fichier de scénarios (.scn) est chargé (mmap) puis compilé en une suite
+ * d'appels ::step, exécutés par un interpréteur générique lié à board.h.
+ *
+ * Format, une instruction par ligne, '#' pour les commentaires :
+ *
+ *     scenario <nom>            début d'un scénario (partie neuve)
+ *     setup <S|N> s0 s1 .. s5   place_piece colonne par colonne, attendu OK
+ *     place <taille> <joueur> <colonne> <code>
+ *     pick <joueur> <ligne> <colonne> <code>
+ *     move <G|S|N|E|W> <code>
+ *     swap <ligne> <colonne> <code>
+ *     cancel <code>             cancel_movement
+ *     step <code>               cancel_step
+ *     possible <dir> <0|1>      is_move_possible
+ *     size <ligne> <colonne> <taille>
+ *     winner <joueur>
+ *     south <ligne>             southmost_occupied_line
+ *     north <ligne>             northmost_occupied_line
+ *     owner <joueur>            picked_piece_owner
+ *     held <taille>             picked_piece_size
+ *     line <ligne>              picked_piece_line
+ *     column <colonne>          picked_piece_column
+ *     left <n>                  movement_left
+ *     available <taille> <joueur> <n>
+ *     board                     suivi de DIMENSION lignes de DIMENSION
+ *                               caractères '.', '1', '2', '3' (nord en haut)
+ *     end                       fin du scénario
+ *
+ * Codes : OK, EMPTY, FORBIDDEN, PARAM, ou '*' pour ignorer le résultat.
+ * Joueurs : S, N, '-' (::NO_PLAYER). Tailles : 0 à 3 ou '-'.
+ * Toute valeur peut aussi être un entier brut, pour tester les paramètres invalides.
+ */
+
+/**
+ * @brief les appels de l'API board.h qu'un ::step peut représenter.
+ */
+typedef enum call_e {
+  CALL_PLACE,          /**< place_piece(a = taille, b = joueur, c = colonne) */
+  CALL_PICK,           /**< pick_piece(a = joueur, b = ligne, c = colonne) */
+  CALL_MOVE,           /**< move_piece(a = direction) */
+  CALL_SWAP,           /**< swap_piece(a = ligne, b = colonne) */
+  CALL_CANCEL_MOVEMENT,/**< cancel_movement() */
+  CALL_CANCEL_STEP,    /**< cancel_step() */
+  CALL_POSSIBLE,       /**< is_move_possible(a = direction) */
+  CALL_SIZE,           /**< get_piece_size(a = ligne, b = colonne) */
+  CALL_WINNER,         /**< get_winner() */
+  CALL_SOUTHMOST,      /**< southmost_occupied_line() */
+  CALL_NORTHMOST,      /**< northmost_occupied_line() */
+  CALL_OWNER,          /**< picked_piece_owner() */
+  CALL_HELD,           /**< picked_piece_size() */
+  CALL_LINE,           /**< picked_piece_line() */
+  CALL_COLUMN,         /**< picked_piece_column() */
+  CALL_LEFT,           /**< movement_left() */
+  CALL_AVAILABLE,      /**< nb_pieces_available(a = taille, b = joueur) */
+  CALL_BOARD,          /**< compare tout le plateau à une grille (indice sur a et b) */
+  NB_CALLS
+} call;
+
+/**
+ * @brief valeur de ::step.expected signifiant « résultat ignoré ».
+ */
+#define ANY_RESULT -128
+
+/**
+ * @brief un appel à l'API et le résultat attendu.
+ */
+typedef struct step_s {
+  signed char call;     /**< un ::call */
+  signed char a, b, c;  /**< arguments, selon l'appel */
+  short expected;       /**< résultat attendu, ::ANY_RESULT pour ignorer */
+  short line;           /**< ligne du fichier source, pour les messages */
+} step;
+
+/**
+ * @brief un scénario : une partie neuve et une suite d'étapes.
+ */
+typedef struct scenario_s {
+  const char *name;     /**< nom, pointe dans le fichier chargé */
+  int name_len;
+  int first;            /**< indice de la première étape */
+  int nb_steps;
+} scenario;
+
+/**
+ * @brief un ensemble de scénarios chargés depuis un ou plusieurs fichiers.
+ */
+typedef struct scenario_set_s {
+  scenario *scenarios;
+  int nb_scenarios, cap_scenarios;
+  step *steps;
+  int nb_steps, cap_steps;
+  signed char (*grids)[DIMENSION][DIMENSION]; /**< plateaux attendus, [ligne][colonne] */
+  int nb_grids, cap_grids;
+  struct {
+    void *addr;
+    size_t len;
+  } *files;                                    /**< fichiers projetés, où pointent les noms */
+  int nb_files, cap_files;
+} scenario_set;
+
+/**
+ * @brief charge un fichier de scénarios et l'ajoute à l'ensemble.
+ * @return 0 en cas de succès, -1 sinon (le message est déjà affiché).
+ */
+int scenario_load(scenario_set *set, const char *path);
+
+/**
+ * @brief libère la mémoire de l'ensemble.
+ */
+void scenario_free(scenario_set *set);
+
+/**
+ * @brief exécute un appel sur la partie et retourne le résultat brut.
+ *
+ * Pour ::CALL_BOARD, retourne 1 si le plateau correspond à la grille, 0 sinon.
+ */
+int step_exec(board game, const step *s, const scenario_set *set);
+
+/**
+ * @brief exécute un scénario complet sur une partie neuve.
+ *
+ * @param failed_step reçoit l'indice de l'étape en échec, -1 si tout passe.
+ * @param got reçoit le résultat obtenu sur l'étape en échec.
+ * @return 1 si le scénario passe, 0 sinon.
+ */
+int scenario_run(const scenario_set *set, const scenario *sc, int *failed_step, int *got);
+
+/**
+ * @brief nom de l'appel, tel qu'écrit dans les fichiers de scénarios.
+ */
+const char *call_name(call c);
+
+#endif /*_SCENARIO_H_*/
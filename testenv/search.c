@@ -0,0 +1,340 @@
+#define _POSIX_C_SOURCE 199309L
+#include "search.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* --- ZOBRIST --- */
+
+static uint64_t zobrist[DIMENSION][DIMENSION][NB_SIZE + 1];
+static uint64_t zobrist_north;
+
+static uint64_t splitmix(uint64_t *s) {
+  uint64_t z = (*s += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+uint64_t zobrist_key(board game, player to_move) {
+  uint64_t k = to_move == NORTH_P ? zobrist_north : 0;
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++) {
+      size s = get_piece_size(game, l, c);
+      if (s != NONE)
+        k ^= zobrist[l][c][s & 3];
+    }
+  return k;
+}
+
+/* --- TABLE DE TRANSPOSITION --- */
+
+/* Une entrée : la clé est stockée xorée avec les données, ce qui détecte
+   les écritures concurrentes entremêlées sans verrou. Données :
+   score (32 bits) | profondeur (8) | borne (2) | meilleur coup (16) */
+typedef struct tt_entry_s {
+  _Atomic uint64_t check;
+  _Atomic uint64_t data;
+} tt_entry;
+
+enum { BOUND_EXACT = 1, BOUND_LOWER = 2, BOUND_UPPER = 3 };
+
+static tt_entry *table = NULL;
+static size_t table_mask = 0;
+
+void search_init(size_t tt_mb) {
+  uint64_t seed = 20240601;
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++)
+      for (int s = 0; s <= NB_SIZE; s++)
+        zobrist[l][c][s] = splitmix(&seed);
+  zobrist_north = splitmix(&seed);
+
+  size_t n = 1;
+  while (n * 2 * sizeof(tt_entry) <= tt_mb * 1024 * 1024)
+    n *= 2;
+  free(table);
+  table = calloc(n, sizeof(tt_entry));
+  table_mask = n - 1;
+}
+
+void search_clear(void) {
+  if (table)
+    memset(table, 0, (table_mask + 1) * sizeof(tt_entry));
+}
+
+void search_free(void) {
+  free(table);
+  table = NULL;
+}
+
+static uint64_t tt_pack(int score, int depth, int bound, int best) {
+  return (uint64_t)(uint32_t)score | (uint64_t)(depth & 0xff) << 32 | (uint64_t)bound << 40 |
+         (uint64_t)(best & 0xffff) << 42;
+}
+
+static int tt_probe(uint64_t key, int *score, int *depth, int *bound, int *best) {
+  tt_entry *e = &table[key & table_mask];
+  uint64_t data = atomic_load_explicit(&e->data, memory_order_relaxed);
+  uint64_t check = atomic_load_explicit(&e->check, memory_order_relaxed);
+  if ((check ^ data) != key || data == 0)
+    return 0;
+  *score = (int32_t)(data & 0xffffffff);
+  *depth = (data >> 32) & 0xff;
+  *bound = (data >> 40) & 3;
+  *best = (data >> 42) & 0xffff;
+  return 1;
+}
+
+static void tt_store(uint64_t key, int score, int depth, int bound, int best) {
+  tt_entry *e = &table[key & table_mask];
+  uint64_t data = tt_pack(score, depth, bound, best);
+  atomic_store_explicit(&e->data, data, memory_order_relaxed);
+  atomic_store_explicit(&e->check, key ^ data, memory_order_relaxed);
+}
+
+/* --- ÉVALUATION --- */
+
+/* Avancée de la ligne d'où joue p, en lignes depuis son camp */
+static int advance(board g, player p) {
+  if (p == SOUTH_P)
+    return southmost_occupied_line(g);
+  int l = northmost_occupied_line(g);
+  return l < 0 ? -1 : DIMENSION - 1 - l;
+}
+
+/* Plus la ligne jouable d'un joueur est proche du but adverse, mieux c'est ;
+   une pièce de taille 1 sur cette ligne menace davantage qu'une de taille 3. */
+static int evaluate(board g, player p) {
+  int score = 100 * (advance(g, p) - advance(g, next_player(p)));
+  int line = p == SOUTH_P ? southmost_occupied_line(g) : northmost_occupied_line(g);
+  if (line >= 0)
+    for (int c = 0; c < DIMENSION; c++)
+      if (get_piece_size(g, line, c) != NONE)
+        score += NB_SIZE + 1 - get_piece_size(g, line, c);
+  return score;
+}
+
+/* --- RECHERCHE --- */
+
+typedef struct child_s {
+  board game;
+  turn t;
+} child;
+
+typedef struct children_s {
+  child *items;
+  int count, cap;
+} children;
+
+static int collect(board after, const turn *t, void *ctx) {
+  children *ch = ctx;
+  if (ch->count == ch->cap) {
+    ch->cap = ch->cap ? ch->cap * 2 : 64;
+    ch->items = realloc(ch->items, ch->cap * sizeof(child));
+  }
+  ch->items[ch->count].game = after;
+  ch->items[ch->count].t = *t;
+  ch->count++;
+  return 1;
+}
+
+static void free_children(children *ch) {
+  for (int i = 0; i < ch->count; i++)
+    destroy_game(ch->items[i].game);
+  free(ch->items);
+}
+
+typedef struct shared_s {
+  struct timespec deadline;
+  int has_deadline;
+  atomic_int stop;
+  atomic_ulong nodes;
+} shared;
+
+typedef struct thread_ctx_s {
+  shared *sh;
+  unsigned long nodes;
+} thread_ctx;
+
+static int time_up(thread_ctx *tc) {
+  if (atomic_load_explicit(&tc->sh->stop, memory_order_relaxed))
+    return 1;
+  if (!tc->sh->has_deadline || (tc->nodes & 255) != 0)
+    return 0;
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (now.tv_sec > tc->sh->deadline.tv_sec ||
+      (now.tv_sec == tc->sh->deadline.tv_sec && now.tv_nsec >= tc->sh->deadline.tv_nsec)) {
+    atomic_store(&tc->sh->stop, 1);
+    return 1;
+  }
+  return 0;
+}
+
+static int negamax(thread_ctx *tc, board g, player p, int depth, int alpha, int beta, int ply) {
+  tc->nodes++;
+  player winner = get_winner(g);
+  if (winner != NO_PLAYER)
+    return winner == p ? SEARCH_WIN - ply : -(SEARCH_WIN - ply);
+  if (depth == 0)
+    return evaluate(g, p);
+  if (time_up(tc))
+    return 0;
+
+  uint64_t key = zobrist_key(g, p);
+  int tt_score, tt_depth, tt_bound, tt_best = -1;
+  if (tt_probe(key, &tt_score, &tt_depth, &tt_bound, &tt_best)) {
+    if (tt_depth >= depth) {
+      if (tt_bound == BOUND_EXACT)
+        return tt_score;
+      if (tt_bound == BOUND_LOWER && tt_score >= beta)
+        return tt_score;
+      if (tt_bound == BOUND_UPPER && tt_score <= alpha)
+        return tt_score;
+    }
+  } else {
+    tt_best = -1;
+  }
+
+  children ch = {0};
+  gen_turns(g, p, collect, &ch);
+  if (ch.count == 0) {
+    free(ch.items);
+    return 0; /* aucun tour possible : partie bloquée */
+  }
+  /* Le meilleur coup connu (indice dans l'ordre de génération) d'abord */
+  if (tt_best >= ch.count)
+    tt_best = -1;
+
+  int best = -SEARCH_WIN - 1, best_index = 0, alpha0 = alpha;
+  for (int k = 0; k < ch.count; k++) {
+    int i = tt_best < 0 ? k : k == 0 ? tt_best : k <= tt_best ? k - 1 : k;
+    int score = -negamax(tc, ch.items[i].game, next_player(p), depth - 1, -beta, -alpha, ply + 1);
+    if (atomic_load_explicit(&tc->sh->stop, memory_order_relaxed))
+      break;
+    if (score > best) {
+      best = score;
+      best_index = i;
+    }
+    if (score > alpha)
+      alpha = score;
+    if (alpha >= beta)
+      break;
+  }
+  free_children(&ch);
+
+  if (atomic_load_explicit(&tc->sh->stop, memory_order_relaxed))
+    return 0;
+  int bound = best <= alpha0 ? BOUND_UPPER : best >= beta ? BOUND_LOWER : BOUND_EXACT;
+  tt_store(key, best, depth, bound, best_index);
+  return best;
+}
+
+/* --- RACINE PARALLÈLE --- */
+
+typedef struct root_s {
+  shared *sh;
+  children *ch;
+  player p;
+  int depth;
+  atomic_int next;
+  atomic_int alpha;
+  int *scores;
+  char *exact; /* score exact, et non borne supérieure d'un échec bas */
+} root;
+
+static void *root_worker(void *arg) {
+  root *r = arg;
+  thread_ctx tc = {r->sh, 0};
+  int i;
+  while ((i = atomic_fetch_add(&r->next, 1)) < r->ch->count) {
+    int alpha = atomic_load(&r->alpha);
+    int score = -negamax(&tc, r->ch->items[i].game, next_player(r->p), r->depth - 1,
+                         -SEARCH_WIN - 1, -alpha, 1);
+    r->scores[i] = score;
+    /* score <= alpha : la fenêtre n'en donne qu'une borne supérieure, qui
+     * peut égaler le score exact du fils qui a fixé alpha */
+    r->exact[i] = score > alpha;
+    int cur = atomic_load(&r->alpha);
+    while (score > cur && !atomic_compare_exchange_weak(&r->alpha, &cur, score))
+      ;
+  }
+  atomic_fetch_add(&r->sh->nodes, tc.nodes);
+  return NULL;
+}
+
+search_result search_best_turn(board game, player current_player, const search_options *options) {
+  search_result res;
+  memset(&res, 0, sizeof(res));
+  if (table == NULL)
+    search_init(16);
+
+  shared sh;
+  memset(&sh, 0, sizeof(sh));
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if (options->time_ms > 0) {
+    sh.has_deadline = 1;
+    sh.deadline = start;
+    sh.deadline.tv_sec += options->time_ms / 1000;
+    sh.deadline.tv_nsec += (options->time_ms % 1000) * 1000000L;
+    if (sh.deadline.tv_nsec >= 1000000000L) {
+      sh.deadline.tv_sec++;
+      sh.deadline.tv_nsec -= 1000000000L;
+    }
+  }
+
+  children ch = {0};
+  gen_turns(game, current_player, collect, &ch);
+  if (ch.count == 0) {
+    free(ch.items);
+    return res;
+  }
+  res.has_move = 1;
+  res.best = ch.items[0].t;
+
+  int nb_threads = options->threads > 0 ? options->threads : 1;
+  pthread_t *threads = malloc(nb_threads * sizeof(pthread_t));
+  int *scores = malloc(ch.count * sizeof(int));
+  char *exact = malloc(ch.count);
+  int max_depth = options->max_depth > 0 ? options->max_depth : 64;
+
+  for (int depth = 1; depth <= max_depth; depth++) {
+    root r = {&sh, &ch, current_player, depth, 0, -SEARCH_WIN - 1, scores, exact};
+    for (int i = 0; i < nb_threads; i++)
+      pthread_create(&threads[i], NULL, root_worker, &r);
+    for (int i = 0; i < nb_threads; i++)
+      pthread_join(threads[i], NULL);
+    if (atomic_load(&sh.stop))
+      break;
+
+    /* le premier fils à atteindre le maximum l'a obtenu au-dessus de alpha :
+     * il y a toujours un score exact parmi les meilleurs */
+    int best = -1;
+    for (int i = 0; i < ch.count; i++)
+      if (exact[i] && (best < 0 || scores[i] > scores[best]))
+        best = i;
+    res.best = ch.items[best].t;
+    res.score = scores[best];
+    res.depth = depth;
+    /* le meilleur coup d'abord à l'itération suivante */
+    child tmp = ch.items[0];
+    ch.items[0] = ch.items[best];
+    ch.items[best] = tmp;
+    if (res.score >= SEARCH_WIN - 64 || res.score <= -SEARCH_WIN + 64)
+      break;
+  }
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  res.nodes = atomic_load(&sh.nodes);
+  res.seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  free(scores);
+  free(exact);
+  free(threads);
+  free_children(&ch);
+  return res;
+}
@@ -0,0 +1,73 @@
+#ifndef _SEARCH_H_
+#define _SEARCH_H_
+
+#include "board.h"
+#include "turns.h"
+#include <stddef.h>
+
+/**
+ * \file search.h
+ *
+ * \brief Recherche alpha-bêta sur des tours complets, au-dessus de board.h.
+ *
+ * Approfondissement itératif, table de transposition de taille fixe indexée
+ * par hachage de Zobrist (lu par get_piece_size), et répartition des coups
+ * de la racine entre plusieurs threads. Sert de charge de travail réaliste
+ * pour mesurer un moteur : nœuds par seconde et profondeur atteinte.
+ */
+
+/**
+ * @brief score d'une victoire (diminué de la distance en demi-coups).
+ */
+#define SEARCH_WIN 100000
+
+/**
+ * @brief paramètres d'une recherche.
+ */
+typedef struct search_options_s {
+  int time_ms;    /**< budget de temps, 0 pour aucun */
+  int max_depth;  /**< profondeur maximale en tours, 0 pour aucune */
+  int threads;    /**< threads pour les coups de la racine */
+} search_options;
+
+/**
+ * @brief résultat d'une recherche.
+ */
+typedef struct search_result_s {
+  int has_move;         /**< 0 si le joueur n'a aucun tour possible */
+  turn best;            /**< meilleur tour de la dernière itération complète */
+  int score;            /**< score du point de vue du joueur */
+  int depth;            /**< profondeur complètement explorée */
+  unsigned long nodes;  /**< nœuds visités */
+  double seconds;       /**< durée de la recherche */
+} search_result;
+
+/**
+ * @brief alloue la table de transposition (puissance de deux, en Mo).
+ */
+void search_init(size_t tt_mb);
+
+/**
+ * @brief vide la table de transposition.
+ */
+void search_clear(void);
+
+/**
+ * @brief libère la table de transposition.
+ */
+void search_free(void);
+
+/**
+ * @brief cherche le meilleur tour de current_player.
+ *
+ * Le moteur lié doit accepter des parties distinctes dans des threads
+ * distincts si options->threads > 1.
+ */
+search_result search_best_turn(board game, player current_player, const search_options *options);
+
+/**
+ * @brief hachage de Zobrist d'une position entre deux tours.
+ */
+uint64_t zobrist_key(board game, player to_move);
+
+#endif /*_SEARCH_H_*/
@@ -0,0 +1,391 @@
+#define _DEFAULT_SOURCE
+#include "board.h"
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGRED "\033[101m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Vérification exhaustive de la phase de placement.
+ *
+ * Toutes les suites de place_piece mènent à un état décrit par le contenu des
+ * deux lignes de départ : l'ordre de placement n'importe pas. On énumère donc
+ * chaque état atteignable une seule fois, et dans chacun on vérifie :
+ *   - le plateau et nb_pieces_available (paramètres invalides compris) ;
+ *   - chaque place_piece illégal (code attendu, plateau inchangé) ;
+ *   - chaque place_piece légal (OK, puis l'état successeur exact).
+ * Chaque transition étant vérifiée, chaque ordre de placement l'est aussi.
+ *
+ * Le travail est réparti entre plusieurs processus (un moteur peut planter).
+ * Sans -t, le délai de chaque processus suit le nombre d'états qu'il vérifie :
+ * la référence en vérifie environ 200 000 par seconde, un moteur correct
+ * jusqu'à vingt fois plus lent passe encore.
+ */
+
+/* Délai par défaut : états par processus / MIN_RATE, au moins MIN_TIMEOUT s */
+#define MIN_RATE 10000
+#define MIN_TIMEOUT 60
+
+/* Contenu d'une ligne de départ : 2 bits par colonne */
+typedef uint64_t line_state;
+
+#define SQUARE(ls, c) ((size)(((ls) >> (2 * (c))) & 3))
+
+static line_state *lines = NULL;
+static int nb_lines = 0;
+
+/* Énumère les lignes respectant NB_INITIAL_PIECES pour chaque taille */
+static void enumerate_lines(int column, line_state ls, int counts[NB_SIZE + 1]) {
+  if (column == DIMENSION) {
+    lines = realloc(lines, (nb_lines + 1) * sizeof(line_state));
+    lines[nb_lines++] = ls;
+    return;
+  }
+  for (int s = NONE; s <= THREE; s++) {
+    if (s != NONE && counts[s] == NB_INITIAL_PIECES)
+      continue;
+    counts[s]++;
+    enumerate_lines(column + 1, ls | (line_state)s << (2 * column), counts);
+    counts[s]--;
+  }
+}
+
+static int line_count(line_state ls, size s) {
+  int n = 0;
+  for (int c = 0; c < DIMENSION; c++)
+    n += SQUARE(ls, c) == s;
+  return n;
+}
+
+/* --- MODÈLE (règles de board.h) --- */
+
+typedef struct state_s {
+  line_state side[NB_PLAYERS + 1]; /* indexé par player, side[NO_PLAYER] inutilisé */
+  int count[NB_PLAYERS + 1][NB_SIZE + 1];
+} state;
+
+static state make_state(line_state south, line_state north) {
+  state st = {{0, south, north}, {{0}}};
+  for (int p = SOUTH_P; p <= NORTH_P; p++)
+    for (int s = ONE; s <= THREE; s++)
+      st.count[p][s] = line_count(st.side[p], s);
+  return st;
+}
+
+static int valid_size(int s) { return s >= ONE && s <= THREE; }
+static int valid_player(int p) { return p == SOUTH_P || p == NORTH_P; }
+static int start_line(player p) { return p == SOUTH_P ? 0 : DIMENSION - 1; }
+
+static int model_available(const state *st, int s, int p) {
+  if (!valid_size(s) || !valid_player(p))
+    return -1;
+  return NB_INITIAL_PIECES - st->count[p][s];
+}
+
+static return_code model_place(const state *st, int s, int p, int c) {
+  if (!valid_size(s) || !valid_player(p) || c < 0 || c >= DIMENSION)
+    return PARAM;
+  if (SQUARE(st->side[p], c) != NONE)
+    return EMPTY;
+  if (st->count[p][s] >= NB_INITIAL_PIECES)
+    return FORBIDDEN;
+  return OK;
+}
+
+/* --- RAPPORT D'ERREURS --- */
+
+typedef struct report_s {
+  long checks, errors, copy_fallbacks, states, transitions;
+  int max_errors;
+  char *buf;
+  size_t len, cap;
+} report;
+
+static void describe(const state *st, char *out) {
+  for (int c = 0; c < DIMENSION; c++)
+    out[c] = ".123"[SQUARE(st->side[SOUTH_P], c)];
+  out[DIMENSION] = '/';
+  for (int c = 0; c < DIMENSION; c++)
+    out[DIMENSION + 1 + c] = ".123"[SQUARE(st->side[NORTH_P], c)];
+  out[2 * DIMENSION + 1] = '\0';
+}
+
+static void failure(report *r, const state *st, const char *what, int expected, int got) {
+  r->errors++;
+  if (r->errors > r->max_errors)
+    return;
+  char desc[2 * DIMENSION + 2], line[256];
+  describe(st, desc);
+  int n = snprintf(line, sizeof(line), "%s ❌ FAIL: [S/N %s] %s%s\n%s      -> Expected: %d, got %d%s\n\n",
+                   RED, desc, what, RESET, RED, expected, got, RESET);
+  if (r->len + n + 1 > r->cap) {
+    r->cap = (r->cap + n + 1) * 2;
+    r->buf = realloc(r->buf, r->cap);
+  }
+  memcpy(r->buf + r->len, line, n + 1);
+  r->len += n;
+}
+
+#define CHECK(r, st, got, expected, ...)                 \
+  do {                                                   \
+    int got_ = (got), exp_ = (expected);                 \
+    (r)->checks++;                                       \
+    if (got_ != exp_) {                                  \
+      char what_[128];                                   \
+      snprintf(what_, sizeof(what_), __VA_ARGS__);       \
+      failure((r), (st), what_, exp_, got_);             \
+    }                                                    \
+  } while (0)
+
+/* --- VÉRIFICATIONS --- */
+
+static board replay(const state *st) {
+  board g = new_game();
+  if (g == NULL)
+    return NULL;
+  for (int p = SOUTH_P; p <= NORTH_P; p++)
+    for (int c = 0; c < DIMENSION; c++)
+      if (SQUARE(st->side[p], c) != NONE)
+        place_piece(g, SQUARE(st->side[p], c), p, c);
+  return g;
+}
+
+static int board_matches(board g, const state *st) {
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++) {
+      size expected = NONE;
+      if (l == start_line(SOUTH_P))
+        expected = SQUARE(st->side[SOUTH_P], c);
+      else if (l == start_line(NORTH_P))
+        expected = SQUARE(st->side[NORTH_P], c);
+      if (get_piece_size(g, l, c) != expected)
+        return 0;
+    }
+  return 1;
+}
+
+/* Vérification complète : tout le plateau, nb_pieces_available y compris invalide */
+static void check_board(report *r, board g, const state *st, const char *when) {
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++) {
+      size expected = NONE;
+      if (l == start_line(SOUTH_P))
+        expected = SQUARE(st->side[SOUTH_P], c);
+      else if (l == start_line(NORTH_P))
+        expected = SQUARE(st->side[NORTH_P], c);
+      CHECK(r, st, get_piece_size(g, l, c), expected, "%s: get_piece_size(g, %d, %d)", when, l, c);
+    }
+  for (int s = NONE - 1; s <= THREE + 1; s++)
+    for (int p = NO_PLAYER - 1; p <= NORTH_P + 1; p++)
+      CHECK(r, st, nb_pieces_available(g, s, p), model_available(st, s, p),
+            "%s: nb_pieces_available(g, %d, %d)", when, s, p);
+}
+
+/* Vérification rapide après un appel : lignes de départ et compteurs valides.
+   Le reste du plateau est vérifié quand l'état successeur est lui-même visité. */
+static void check_lines(report *r, board g, const state *st, const char *when) {
+  for (int p = SOUTH_P; p <= NORTH_P; p++) {
+    for (int c = 0; c < DIMENSION; c++)
+      CHECK(r, st, get_piece_size(g, start_line(p), c), SQUARE(st->side[p], c),
+            "%s: get_piece_size(g, %d, %d)", when, start_line(p), c);
+    for (int s = ONE; s <= THREE; s++)
+      CHECK(r, st, nb_pieces_available(g, s, p), model_available(st, s, p),
+            "%s: nb_pieces_available(g, %d, %d)", when, s, p);
+  }
+}
+
+static void check_state(report *r, const state *st) {
+  board g = replay(st);
+  if (g == NULL) {
+    failure(r, st, "new_game returned NULL", 1, 0);
+    return;
+  }
+  r->states++;
+  check_board(r, g, st, "state");
+
+  /* Tentatives illégales : codes d'erreur, sans effet sur le plateau.
+     Les paramètres invalides sont essayés un par un (les deux autres valides),
+     puis tous ensemble, ce qui couvre l'ordre PARAM, EMPTY, FORBIDDEN. */
+  int illegal = 0;
+  for (int s = NONE - 1; s <= THREE + 1; s++)
+    for (int p = NO_PLAYER - 1; p <= NORTH_P + 1; p++)
+      for (int c = -1; c <= DIMENSION; c++) {
+        int invalid = !valid_size(s) + !valid_player(p) + (c < 0 || c >= DIMENSION);
+        if (invalid == 2)
+          continue;
+        return_code expected = model_place(st, s, p, c);
+        if (expected == OK)
+          continue;
+        illegal++;
+        CHECK(r, st, place_piece(g, s, p, c), expected, "place_piece(g, %d, %d, %d)", s, p, c);
+      }
+  if (illegal)
+    check_lines(r, g, st, "after illegal calls");
+
+  /* Placements légaux : un successeur par copie, ou par rejeu si copy_game est faux */
+  for (int s = ONE; s <= THREE; s++)
+    for (int p = SOUTH_P; p <= NORTH_P; p++)
+      for (int c = 0; c < DIMENSION; c++) {
+        if (model_place(st, s, p, c) != OK)
+          continue;
+        r->transitions++;
+        board child = copy_game(g);
+        if (child == NULL || !board_matches(child, st)) {
+          r->copy_fallbacks++;
+          if (child != NULL)
+            destroy_game(child);
+          child = replay(st);
+        }
+        state next = *st;
+        next.side[p] |= (line_state)s << (2 * c);
+        next.count[p][s]++;
+        CHECK(r, st, place_piece(child, s, p, c), OK, "place_piece(g, %d, %d, %d)", s, p, c);
+        char when[64];
+        snprintf(when, sizeof(when), "after place_piece(g, %d, %d, %d)", s, p, c);
+        check_lines(r, child, &next, when);
+        destroy_game(child);
+      }
+  destroy_game(g);
+}
+
+/* --- RÉPARTITION --- */
+
+typedef struct shared_s {
+  long checks, errors, copy_fallbacks, states, transitions;
+  long current; /* indice de l'état en cours, pour les plantages */
+} shared;
+
+static void worker(int w, int nb_workers, shared *out, int max_errors, int out_fd) {
+  report r = {0};
+  r.max_errors = max_errors;
+  long total = (long)nb_lines * nb_lines;
+  for (long i = w; i < total; i += nb_workers) {
+    out->current = i;
+    state st = make_state(lines[i / nb_lines], lines[i % nb_lines]);
+    check_state(&r, &st);
+  }
+  out->checks = r.checks;
+  out->errors = r.errors;
+  out->copy_fallbacks = r.copy_fallbacks;
+  out->states = r.states;
+  out->transitions = r.transitions;
+  out->current = -1;
+  if (r.len && write(out_fd, r.buf, r.len) < 0)
+    perror("write");
+  free(r.buf);
+}
+
+static double now_s(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-j workers] [-t timeout_s] [-m max_errors]\n", prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  int nb_workers = (int)sysconf(_SC_NPROCESSORS_ONLN), timeout = 0, max_errors = 10;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      nb_workers = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      timeout = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+      max_errors = atoi(argv[++i]);
+    else
+      usage(argv[0]);
+  }
+  if (nb_workers < 1)
+    nb_workers = 1;
+
+  int counts[NB_SIZE + 1] = {0};
+  enumerate_lines(0, 0, counts);
+  long total = (long)nb_lines * nb_lines;
+  if (timeout <= 0) {
+    long per_worker = (total + nb_workers - 1) / nb_workers;
+    timeout = per_worker / MIN_RATE > MIN_TIMEOUT ? (int)(per_worker / MIN_RATE) : MIN_TIMEOUT;
+  }
+  printf("%s=== PLACEMENT EXHAUSTIF : %d lignes, %ld états, %d processus, %d s chacun ===%s\n\n",
+         BGBLUE, nb_lines, total, nb_workers, timeout, RESET);
+  fflush(stdout);
+
+  shared *res = mmap(NULL, nb_workers * sizeof(shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (res == MAP_FAILED) {
+    perror("mmap");
+    return 2;
+  }
+  pid_t *pids = calloc(nb_workers, sizeof(pid_t));
+  double start = now_s();
+  for (int w = 0; w < nb_workers; w++) {
+    res[w].current = -1;
+    pids[w] = fork();
+    if (pids[w] < 0) {
+      perror("fork");
+      return 2;
+    }
+    if (pids[w] == 0) {
+      alarm(timeout);
+      worker(w, nb_workers, &res[w], max_errors, STDOUT_FILENO);
+      _exit(0);
+    }
+  }
+
+  int ok = 1;
+  long checks = 0, errors = 0, fallbacks = 0, states = 0, transitions = 0;
+  for (int w = 0; w < nb_workers; w++) {
+    int status;
+    waitpid(pids[w], &status, 0);
+    if (WIFSIGNALED(status)) {
+      ok = 0;
+      long i = res[w].current;
+      const char *why = WTERMSIG(status) == SIGALRM ? "timeout" : strsignal(WTERMSIG(status));
+      /* plantage avant le premier état : rien à décrire */
+      if (i < 0) {
+        printf("%s ❌ CRASH: signal %d (%s) before the first state%s\n\n", RED, WTERMSIG(status), why, RESET);
+        continue;
+      }
+      state st = make_state(lines[i / nb_lines], lines[i % nb_lines]);
+      char desc[2 * DIMENSION + 2];
+      describe(&st, desc);
+      printf("%s ❌ CRASH: signal %d (%s) in state [S/N %s]%s\n\n", RED, WTERMSIG(status), why, desc, RESET);
+      continue;
+    }
+    checks += res[w].checks;
+    errors += res[w].errors;
+    fallbacks += res[w].copy_fallbacks;
+    states += res[w].states;
+    transitions += res[w].transitions;
+  }
+  double elapsed = now_s() - start;
+
+  if (errors)
+    ok = 0;
+  printf("%s%ld états, %ld transitions, %ld/%ld vérifications passées en %.2f s.%s\n",
+         bgyellow, states, transitions, checks - errors, checks, elapsed, RESET);
+  if (fallbacks)
+    printf("%s%ld copies incorrectes (copy_game), états reconstruits par rejeu.%s\n", BGRED, fallbacks, RESET);
+  if (ok)
+    printf("%s 🎉 PLACEMENT CONFORME %s\n", GREEN, RESET);
+  else
+    printf("%s ❌ PLACEMENT NON CONFORME (%ld erreurs) %s\n", RED, errors, RESET);
+
+  free(pids);
+  free(lines);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#define _DEFAULT_SOURCE
+#include "snapshot.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define MAX_SNAPSHOTS 16
+/* délai de la vérification d'une copie, en secondes */
+#define CHECK_TIMEOUT 5
+
+typedef struct snapshot_s {
+  const char *key;
+  board game;
+} snapshot;
+
+static snapshot snapshots[MAX_SNAPSHOTS];
+static int nb_snapshots = 0;
+/* -1 tant que BOARD_SNAPSHOT n'est pas lu, puis 1 pour copier, 0 pour rejouer */
+static int cloning = -1;
+
+bool snapshot_cloning(void) {
+  if (cloning < 0) {
+    const char *s = getenv("BOARD_SNAPSHOT");
+    cloning = s == NULL || strcmp(s, "0") != 0;
+  }
+  return cloning;
+}
+
+/* --- VÉRIFICATION DE COPY_GAME --- */
+
+/* Moteur appelé sans les enveloppes de recorder.c (-Wl,--wrap) : la
+ * vérification n'apparaît ni dans les enregistrements ni dans le traceur */
+board __real_copy_game(board original_game);
+void __real_destroy_game(board game);
+size __real_get_piece_size(board game, int line, int column);
+player __real_get_winner(board game);
+int __real_southmost_occupied_line(board game);
+int __real_northmost_occupied_line(board game);
+player __real_picked_piece_owner(board game);
+size __real_picked_piece_size(board game);
+int __real_picked_piece_line(board game);
+int __real_picked_piece_column(board game);
+int __real_movement_left(board game);
+int __real_nb_pieces_available(board game, size piece, player player);
+return_code __real_pick_piece(board game, player current_player, int line, int column);
+
+/* Fournie par les sanitizers : le rappel du programme (fuzz) ne doit pas
+ * être appelé depuis le processus de vérification */
+extern void __sanitizer_set_death_callback(void (*callback)(void)) __attribute__((weak));
+
+/* Cases, pièces disponibles, pièce en main, vainqueur et lignes extrêmes */
+#define NB_OBSERVED (DIMENSION * DIMENSION + 2 * NB_SIZE + 8)
+
+static void observe(board g, int out[NB_OBSERVED]) {
+  int n = 0;
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++)
+      out[n++] = __real_get_piece_size(g, l, c);
+  for (size s = ONE; s <= THREE; s++) {
+    out[n++] = __real_nb_pieces_available(g, s, SOUTH_P);
+    out[n++] = __real_nb_pieces_available(g, s, NORTH_P);
+  }
+  out[n++] = __real_picked_piece_owner(g);
+  out[n++] = __real_picked_piece_size(g);
+  out[n++] = __real_picked_piece_line(g);
+  out[n++] = __real_picked_piece_column(g);
+  out[n++] = __real_movement_left(g);
+  out[n++] = __real_get_winner(g);
+  out[n++] = __real_southmost_occupied_line(g);
+  out[n++] = __real_northmost_occupied_line(g);
+}
+
+/* Prend une pièce de la ligne jouable de l'un des joueurs ; faux si aucune prise n'est permise */
+static bool pick_any(board g) {
+  for (player p = SOUTH_P; p <= NORTH_P; p++) {
+    int line = p == SOUTH_P ? __real_southmost_occupied_line(g) : __real_northmost_occupied_line(g);
+    for (int c = 0; c < DIMENSION; c++)
+      if (__real_pick_piece(g, p, line, c) == OK)
+        return true;
+  }
+  return false;
+}
+
+/* La copie a le même état que l'original, et une prise sur la copie ne le change pas */
+static bool check_copy(board g) {
+  int original[NB_OBSERVED], copied[NB_OBSERVED];
+  observe(g, original);
+  board c = __real_copy_game(g);
+  if (c == NULL)
+    return false;
+  observe(c, copied);
+  if (memcmp(original, copied, sizeof(original)) != 0)
+    return false;
+  if (pick_any(c)) {
+    observe(g, copied);
+    if (memcmp(original, copied, sizeof(original)) != 0)
+      return false;
+  }
+  __real_destroy_game(c);
+  return true;
+}
+
+/* Vérification dans un processus fils : un copy_game (ou pick_piece) qui
+ * plante, boucle ou corrompt la mémoire ne touche pas le programme de test.
+ * Retourne 0 si la copie est correcte, -1 si elle ne l'est pas, sinon le
+ * signal qui a terminé le fils. */
+static int copy_check(board g) {
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid < 0)
+    return -1;
+  if (pid == 0) {
+    /* plantage par défaut : ni les gestionnaires du programme (traceur,
+       enregistrement, entrée du fuzzer) ni les rapports des sanitizers */
+    static const int sigs[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGALRM};
+    for (int i = 0; i < (int)(sizeof(sigs) / sizeof(sigs[0])); i++)
+      signal(sigs[i], SIG_DFL);
+    if (__sanitizer_set_death_callback)
+      __sanitizer_set_death_callback(NULL);
+    int null = open("/dev/null", O_WRONLY);
+    if (null >= 0)
+      dup2(null, STDERR_FILENO);
+    alarm(CHECK_TIMEOUT);
+    _exit(check_copy(g) ? 0 : 1);
+  }
+  int status;
+  while (waitpid(pid, &status, 0) < 0)
+    if (errno != EINTR)
+      return -1;
+  if (WIFSIGNALED(status))
+    return WTERMSIG(status);
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+/* --- CACHE --- */
+
+static snapshot *find(const char *key) {
+  for (int i = 0; i < nb_snapshots; i++)
+    if (strcmp(snapshots[i].key, key) == 0)
+      return &snapshots[i];
+  return NULL;
+}
+
+/* Construit la position de la clé et vérifie sa première copie */
+static snapshot *add(const char *key, snapshot_builder build) {
+  if (nb_snapshots == MAX_SNAPSHOTS)
+    return NULL;
+  board g = new_game();
+  if (g == NULL)
+    return NULL;
+  build(g);
+  snapshot *s = &snapshots[nb_snapshots++];
+  s->key = key;
+  s->game = g;
+  int check = copy_check(g);
+  if (check < 0)
+    fprintf(stderr, "copy_game : copie incorrecte ou non indépendante de la position « %s », "
+                    "les positions de départ sont rejouées\n", key);
+  else if (check != 0)
+    fprintf(stderr, "copy_game : la vérification de la copie de la position « %s » a planté (%s), "
+                    "les positions de départ sont rejouées\n", key, check == SIGALRM ? "délai dépassé" : strsignal(check));
+  if (check != 0)
+    cloning = 0;
+  return s;
+}
+
+board snapshot_take(const char *key, snapshot_builder build) {
+  if (snapshot_cloning()) {
+    snapshot *s = find(key);
+    if (s == NULL)
+      s = add(key, build);
+    if (s != NULL && cloning) {
+      board c = copy_game(s->game);
+      if (c != NULL)
+        return c;
+    }
+  }
+  board g = new_game();
+  if (g != NULL)
+    build(g);
+  return g;
+}
+
+void snapshot_clear(void) {
+  /* après un refus, les copies déjà données ont pu partager la mémoire des
+     originaux : rien n'est détruit */
+  if (!cloning)
+    return;
+  for (int i = 0; i < nb_snapshots; i++)
+    destroy_game(snapshots[i].game);
+  nb_snapshots = 0;
+}
@@ -0,0 +1,54 @@
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+#include "board.h"
+
+/**
+ * \file snapshot.h
+ *
+ * \brief Positions de départ partagées, construites une fois puis copiées.
+ *
+ * La plupart des tests commencent par new_game et le même placement (puis
+ * parfois les mêmes premiers coups). Une position est construite une fois
+ * par une fonction de préfixe, gardée sous sa clé, puis chaque demande en
+ * reçoit une copie par copy_game.
+ *
+ * La première copie d'une clé est vérifiée contre la partie construite :
+ * même état observable par l'API (cases, pièces disponibles, pièce en main,
+ * vainqueur), et une prise de pièce sur la copie ne doit pas être visible
+ * sur l'original. La vérification se fait dans un processus fils, en
+ * appelant le moteur sans les enveloppes de recorder.c (d'où -Wl,--wrap à
+ * l'édition des liens) : un plantage ou un blocage de copy_game n'arrête
+ * pas le programme de test, et ces appels n'apparaissent ni dans les
+ * enregistrements ni dans le traceur. Si copy_game échoue à cette
+ * vérification, les copies sont abandonnées pour tout le processus et
+ * chaque demande rejoue le préfixe sur une partie neuve : les tests ne
+ * dépendent pas de la correction de copy_game. BOARD_SNAPSHOT=0 force ce
+ * rejeu.
+ */
+
+/**
+ * @brief fonction de préfixe : amène une partie neuve à la position voulue.
+ */
+typedef void (*snapshot_builder)(board game);
+
+/**
+ * @brief une partie à la position de la clé, à détruire par l'appelant.
+ *
+ * @param key nom de la position ; une même clé doit toujours être donnée
+ *   avec la même fonction de préfixe.
+ * @param build construit la position depuis new_game.
+ */
+board snapshot_take(const char *key, snapshot_builder build);
+
+/**
+ * @brief vrai si les positions sont copiées, faux si elles sont rejouées.
+ */
+bool snapshot_cloning(void);
+
+/**
+ * @brief détruit les positions gardées.
+ */
+void snapshot_clear(void);
+
+#endif /*_SNAPSHOT_H_*/
@@ -0,0 +1,58 @@
+#include "symmetry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool mirror = false, flip = false;
+static const char *name = NULL;
+
+void sym_set(bool m, bool f) {
+  mirror = m;
+  flip = f;
+  name = mirror && flip ? "miroir est-ouest et retournement nord-sud"
+         : mirror      ? "miroir est-ouest"
+         : flip        ? "retournement nord-sud"
+                       : NULL;
+}
+
+__attribute__((constructor)) static void symmetry_init(void) {
+  const char *s = getenv("BOARD_SYMMETRY");
+  if (s == NULL || *s == '\0')
+    return;
+  sym_set(strcmp(s, "mirror") == 0 || strcmp(s, "both") == 0, strcmp(s, "flip") == 0 || strcmp(s, "both") == 0);
+  if (name == NULL) {
+    fprintf(stderr, "BOARD_SYMMETRY=%s inconnu (mirror, flip ou both)\n", s);
+    exit(2);
+  }
+  printf("\033[48;2;100;100;200m=== SYMÉTRIE : %s ===\033[0m\n\n", name);
+}
+
+const char *sym_name(void) {
+  return name;
+}
+
+bool sym_flipped(void) {
+  return flip;
+}
+
+int sym_line(int line) {
+  return flip && line >= 0 && line < DIMENSION ? DIMENSION - 1 - line : line;
+}
+
+int sym_column(int column) {
+  return mirror && column >= 0 && column < DIMENSION ? DIMENSION - 1 - column : column;
+}
+
+player sym_player(player p) {
+  if (!flip)
+    return p;
+  return p == SOUTH_P ? NORTH_P : p == NORTH_P ? SOUTH_P : p;
+}
+
+direction sym_direction(direction d) {
+  if (flip && (d == SOUTH || d == NORTH))
+    return d == SOUTH ? NORTH : SOUTH;
+  if (mirror && (d == EAST || d == WEST))
+    return d == EAST ? WEST : EAST;
+  return d;
+}
@@ -0,0 +1,59 @@
+#ifndef _SYMMETRY_H_
+#define _SYMMETRY_H_
+
+#include "board.h"
+
+/**
+ * \file symmetry.h
+ *
+ * \brief Variantes symétriques des tests, appliquées entre le test et le moteur.
+ *
+ * Les règles sont invariantes par miroir est-ouest (colonne C devient
+ * DIMENSION-1-C, ::EAST et ::WEST échangés) et par retournement nord-sud
+ * (ligne L devient DIMENSION-1-L, ::SOUTH_P et ::NORTH_P échangés, ::SOUTH et
+ * ::NORTH échangés, southmost et northmost échangés). La variable
+ * BOARD_SYMMETRY choisit la variante : mirror, flip ou both (fuzz les choisit
+ * tour à tour par sym_set). Les enveloppes
+ * de recorder.c transforment chaque appel avant le moteur et chaque résultat
+ * au retour : un moteur correct donne au test exactement les mêmes réponses.
+ *
+ * Les valeurs invalides (hors plateau, joueur ou direction inconnus) ne sont
+ * pas transformées, pour que les tests de paramètres restent valables.
+ */
+
+/**
+ * @brief choisit la variante depuis le programme, à la place de BOARD_SYMMETRY.
+ */
+void sym_set(bool mirror, bool flip);
+
+/**
+ * @brief nom de la variante active, NULL si aucune.
+ */
+const char *sym_name(void);
+
+/**
+ * @brief vrai si le nord et le sud sont échangés.
+ */
+bool sym_flipped(void);
+
+/**
+ * @brief image d'une ligne (involution).
+ */
+int sym_line(int line);
+
+/**
+ * @brief image d'une colonne (involution).
+ */
+int sym_column(int column);
+
+/**
+ * @brief image d'un joueur (involution).
+ */
+player sym_player(player p);
+
+/**
+ * @brief image d'une direction (involution).
+ */
+direction sym_direction(direction d);
+
+#endif /*_SYMMETRY_H_*/
@@ -0,0 +1,912 @@
+#define _DEFAULT_SOURCE
+#include "board.h"
+#include "engine.h"
+#include "turns.h"
+#include <dlfcn.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGRED "\033[101m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Table de finales par analyse rétrograde, pour vérifier exhaustivement la
+ * détection du vainqueur.
+ *
+ * Les pièces ne quittent pas le plateau (sauf celle qui gagne) : il n'y a pas
+ * de finale « à peu de pièces ». La table porte donc sur un petit plateau
+ * (DIMENSION 4 : six pièces sur seize cases), où chaque case est à quelques
+ * lignes d'un but et où toutes les positions s'énumèrent.
+ *
+ * 1. Parcours en largeur depuis le placement standard (toutes les lignes de
+ *    départ avec -a), par gen_turns sur le moteur de référence : positions
+ *    atteignables, successeurs de chacune et un parent par position.
+ * 2. Passes rétrogrades, réparties entre threads par tranches d'index. Gain
+ *    en 1 : un tour fait gagner le joueur au trait. Passe n : gain en n si un
+ *    successeur est perdu en n - 1, perte en n si tous les successeurs sont
+ *    gagnés en moins de n. Les positions jamais résolues sont nulles (cycles),
+ *    comme celles où le joueur au trait n'a aucun tour.
+ * 3. Vérification de moteurs (.so, même DIMENSION) : chaque position de la
+ *    table est atteinte chez le moteur en rejouant les tours de référence le
+ *    long de l'arbre du parcours. On y compare le plateau, get_winner (aucun
+ *    vainqueur) et le nombre de tours qui font gagner le joueur au trait
+ *    d'après get_winner, à ceux de la référence. Le travail est réparti entre
+ *    plusieurs processus (un moteur peut planter).
+ *
+ * La référence exporte position_game (hors board.h) pour construire une
+ * position à partir de son index. Index : rang combinatoire des cases de
+ * chaque taille, puis le joueur au trait. Une entrée de la table tient sur un
+ * octet : 2 bits de résultat, 6 bits de distance (en tours des deux joueurs).
+ *
+ *   ./tablebase [-r reference.so] [-a] [-c] [-j threads] [-i|-o table] [-t timeout_s]
+ *               [-m max_rapports] [moteur.so...]
+ *
+ * Les moteurs sont chargés une première fois avant le calcul de la table,
+ * pour qu'un .so introuvable ou incomplet ne soit pas découvert après
+ * plusieurs minutes ; -c s'arrête après ce contrôle.
+ *
+ * Fichier de table (-o, relu par -i), entiers petit-boutistes :
+ *   "GTBL" u32 version, u32 DIMENSION, u32 positions, puis par position une
+ *   entrée (u8) et un parent (u32, 0xffffffff si non atteinte, elle-même
+ *   pour une position après placement)
+ */
+
+#if DIMENSION > 5
+#error "tablebase : DIMENSION 5 au plus (make runtablebase compile avec TB_DIMENSION)"
+#endif
+
+#define SQUARES (DIMENSION * DIMENSION)
+/* pièces de chaque taille sur le plateau */
+#define PER_SIZE (NB_PLAYERS * NB_INITIAL_PIECES)
+
+#define NO_INDEX UINT32_MAX
+
+/* --- INDEX DES POSITIONS --- */
+
+static uint64_t binom[SQUARES + 1][PER_SIZE + 1];
+/* rangs possibles des cases de chaque taille, parmi les cases restantes */
+static uint64_t nb_ranks[NB_SIZE + 1];
+static uint32_t nb_positions;
+
+static void init_index(void) {
+  for (int n = 0; n <= SQUARES; n++) {
+    binom[n][0] = 1;
+    for (int k = 1; k <= PER_SIZE; k++)
+      binom[n][k] = n == 0 ? 0 : binom[n - 1][k - 1] + binom[n - 1][k];
+  }
+  uint64_t total = 2;
+  for (size s = ONE; s <= THREE; s++) {
+    nb_ranks[s] = binom[SQUARES - (s - 1) * PER_SIZE][PER_SIZE];
+    total *= nb_ranks[s];
+  }
+  nb_positions = (uint32_t)total;
+}
+
+static void read_grid(board g, size grid[DIMENSION][DIMENSION]) {
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++)
+      grid[l][c] = get_piece_size(g, l, c);
+}
+
+/* Rang colex des cases de chaque taille parmi celles que les tailles
+   inférieures laissent libres ; -1 si le plateau n'a pas PER_SIZE pièces
+   de chaque taille */
+static int64_t grid_index(size grid[DIMENSION][DIMENSION], player to_move) {
+  const size *sq = &grid[0][0];
+  uint64_t r = 0;
+  for (size s = ONE; s <= THREE; s++) {
+    uint64_t rs = 0;
+    int k = 0, pos = 0;
+    for (int q = 0; q < SQUARES; q++) {
+      if (sq[q] != NONE && sq[q] < s)
+        continue;
+      if (sq[q] == s && k < PER_SIZE)
+        rs += binom[pos][++k];
+      else if (sq[q] == s)
+        return -1;
+      pos++;
+    }
+    if (k != PER_SIZE)
+      return -1;
+    r = r * nb_ranks[s] + rs;
+  }
+  return (int64_t)(2 * r + (to_move == NORTH_P));
+}
+
+static int64_t board_index(board g, player to_move) {
+  size grid[DIMENSION][DIMENSION];
+  read_grid(g, grid);
+  for (int q = 0; q < SQUARES; q++)
+    if (grid[q / DIMENSION][q % DIMENSION] > THREE)
+      return -1;
+  return grid_index(grid, to_move);
+}
+
+static player index_grid(uint32_t index, size grid[DIMENSION][DIMENSION]) {
+  size *sq = &grid[0][0];
+  uint64_t r = index >> 1, ranks[NB_SIZE + 1];
+  for (size s = THREE; s >= ONE; s--) {
+    ranks[s] = r % nb_ranks[s];
+    r /= nb_ranks[s];
+  }
+  memset(sq, 0, SQUARES * sizeof(size));
+  for (size s = ONE; s <= THREE; s++) {
+    int free_sq[SQUARES], nb_free = 0;
+    for (int q = 0; q < SQUARES; q++)
+      if (sq[q] == NONE)
+        free_sq[nb_free++] = q;
+    uint64_t rs = ranks[s];
+    int pos = nb_free - 1;
+    for (int k = PER_SIZE; k >= 1; k--) {
+      while (binom[pos][k] > rs)
+        pos--;
+      rs -= binom[pos][k];
+      sq[free_sq[pos]] = s;
+      pos--;
+    }
+  }
+  return index & 1 ? NORTH_P : SOUTH_P;
+}
+
+/* Position construite par la référence (voir reference/board.c) */
+typedef board (*position_fn)(const size grid[DIMENSION][DIMENSION]);
+static position_fn position_game = NULL;
+
+static board index_board(uint32_t index, player *to_move) {
+  size grid[DIMENSION][DIMENSION];
+  *to_move = index_grid(index, grid);
+  return position_game((const size(*)[DIMENSION])grid);
+}
+
+/* --- TABLE --- */
+
+/* Entrée : résultat pour le joueur au trait (2 bits), distance (6 bits) */
+enum { TB_NONE, TB_DRAW, TB_WIN, TB_LOSS };
+#define TB_ENTRY(r, n) ((uint8_t)((r) << 6 | (n)))
+#define TB_RESULT(e) ((e) >> 6)
+#define TB_DIST(e) ((e)&63)
+#define TB_MAX_DIST 63
+
+static uint8_t *table;     /* TB_NONE : non atteinte ; TB_DRAW : pas (encore) résolue */
+static uint32_t *parent;   /* arbre du parcours, pour atteindre chaque position */
+static uint32_t **succ;    /* successeurs distincts des positions sans gain en 1 */
+static uint16_t *nb_succ;
+
+static uint32_t *roots;
+static int nb_roots = 0, cap_roots = 0;
+static int all_setups = 0;
+
+static double now_s(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* --- PARCOURS EN LARGEUR --- */
+
+#define ARENA_WORDS (1 << 20)
+#define BATCH 64
+
+typedef struct worker_s {
+  pthread_t thread;
+  /* positions découvertes au niveau suivant */
+  uint32_t *next;
+  size_t nb_next, cap_next;
+  /* arène des listes de successeurs */
+  uint32_t *arena;
+  size_t arena_left;
+  /* successeurs de la position en cours */
+  uint32_t *buf;
+  size_t nb_buf, cap_buf;
+  player mover;
+  int wins, bad;
+  unsigned long turns;
+  /* passes rétrogrades */
+  uint32_t lo, hi;
+  int pass;
+  unsigned long resolved;
+} worker;
+
+static const uint32_t *level;
+static size_t level_size;
+static size_t level_pos;
+
+static void push(uint32_t **a, size_t *n, size_t *cap, uint32_t v) {
+  if (*n == *cap) {
+    *cap = *cap ? *cap * 2 : 1024;
+    *a = realloc(*a, *cap * sizeof(uint32_t));
+  }
+  (*a)[(*n)++] = v;
+}
+
+static int on_turn(board after, const turn *t, void *ctx) {
+  (void)t;
+  worker *w = ctx;
+  w->turns++;
+  player winner = get_winner(after);
+  if (winner == w->mover) {
+    w->wins++;
+    return 0;
+  }
+  int64_t idx = winner == NO_PLAYER ? board_index(after, next_player(w->mover)) : -1;
+  if (idx < 0) {
+    w->bad++;
+    return 0;
+  }
+  push(&w->buf, &w->nb_buf, &w->cap_buf, (uint32_t)idx);
+  return 0;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void expand_position(worker *w, uint32_t p) {
+  board g = index_board(p, &w->mover);
+  w->nb_buf = 0;
+  w->wins = 0;
+  gen_turns(g, w->mover, on_turn, w);
+  destroy_game(g);
+
+  size_t n = 0;
+  qsort(w->buf, w->nb_buf, sizeof(uint32_t), cmp_u32);
+  for (size_t i = 0; i < w->nb_buf; i++)
+    if (n == 0 || w->buf[n - 1] != w->buf[i])
+      w->buf[n++] = w->buf[i];
+  for (size_t i = 0; i < n; i++) {
+    uint32_t expected = NO_INDEX;
+    if (__atomic_compare_exchange_n(&parent[w->buf[i]], &expected, p, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      push(&w->next, &w->nb_next, &w->cap_next, w->buf[i]);
+  }
+
+  if (w->wins) {
+    table[p] = TB_ENTRY(TB_WIN, 1);
+    return;
+  }
+  table[p] = TB_ENTRY(TB_DRAW, 0);
+  if (n > w->arena_left) {
+    w->arena_left = n > ARENA_WORDS ? n : ARENA_WORDS;
+    w->arena = malloc(w->arena_left * sizeof(uint32_t));
+  }
+  memcpy(w->arena, w->buf, n * sizeof(uint32_t));
+  succ[p] = w->arena;
+  nb_succ[p] = (uint16_t)n;
+  w->arena += n;
+  w->arena_left -= n;
+}
+
+static void *expand(void *arg) {
+  worker *w = arg;
+  for (;;) {
+    size_t start = __atomic_fetch_add(&level_pos, BATCH, __ATOMIC_RELAXED);
+    if (start >= level_size)
+      break;
+    size_t end = start + BATCH < level_size ? start + BATCH : level_size;
+    for (size_t i = start; i < end; i++)
+      expand_position(w, level[i]);
+  }
+  return NULL;
+}
+
+/* --- PASSES RÉTROGRADES --- */
+
+static void *solve_slice(void *arg) {
+  worker *w = arg;
+  int k = w->pass;
+  w->resolved = 0;
+  for (uint32_t i = w->lo; i < w->hi; i++) {
+    if (TB_RESULT(table[i]) != TB_DRAW || nb_succ[i] == 0)
+      continue;
+    int win = 0, all_won = 1;
+    for (int j = 0; j < nb_succ[i]; j++) {
+      /* les entrées résolues à cette passe (distance k) sont ignorées */
+      uint8_t e = __atomic_load_n(&table[succ[i][j]], __ATOMIC_RELAXED);
+      if (TB_RESULT(e) == TB_LOSS && TB_DIST(e) < k) {
+        win = 1;
+        break;
+      }
+      if (TB_RESULT(e) != TB_WIN || TB_DIST(e) >= k)
+        all_won = 0;
+    }
+    if (win || all_won) {
+      __atomic_store_n(&table[i], TB_ENTRY(win ? TB_WIN : TB_LOSS, k), __ATOMIC_RELAXED);
+      w->resolved++;
+    }
+  }
+  return NULL;
+}
+
+/* --- POSITIONS APRÈS PLACEMENT --- */
+
+static int nb_lines = 0;
+static size (*lines)[DIMENSION] = NULL;
+
+static void enumerate_lines(int column, size line[DIMENSION], int counts[NB_SIZE + 1]) {
+  if (column == DIMENSION) {
+    for (size s = ONE; s <= THREE; s++)
+      if (counts[s] != NB_INITIAL_PIECES)
+        return;
+    lines = realloc(lines, (nb_lines + 1) * sizeof(*lines));
+    memcpy(lines[nb_lines++], line, sizeof(*lines));
+    return;
+  }
+  for (size s = NONE; s <= THREE; s++) {
+    if (s != NONE && counts[s] == NB_INITIAL_PIECES)
+      continue;
+    line[column] = s;
+    counts[s]++;
+    enumerate_lines(column + 1, line, counts);
+    counts[s]--;
+  }
+}
+
+static void add_root(uint32_t r) {
+  if (parent[r] != NO_INDEX)
+    return;
+  parent[r] = r;
+  if (nb_roots == cap_roots) {
+    cap_roots = cap_roots ? 2 * cap_roots : 64;
+    roots = realloc(roots, cap_roots * sizeof(uint32_t));
+  }
+  roots[nb_roots++] = r;
+}
+
+static void root_grid(uint32_t r, size south[DIMENSION], size north[DIMENSION]) {
+  size grid[DIMENSION][DIMENSION];
+  index_grid(r, grid);
+  memcpy(south, grid[0], sizeof(size) * DIMENSION);
+  memcpy(north, grid[DIMENSION - 1], sizeof(size) * DIMENSION);
+}
+
+static void find_roots(void) {
+  size grid[DIMENSION][DIMENSION];
+  if (!all_setups) {
+    memset(grid, 0, sizeof(grid));
+    for (int c = 0; c < DIMENSION; c++)
+      grid[0][c] = grid[DIMENSION - 1][c] = standard_piece(c);
+    add_root((uint32_t)grid_index(grid, SOUTH_P));
+    return;
+  }
+  size line[DIMENSION];
+  int counts[NB_SIZE + 1] = {0};
+  enumerate_lines(0, line, counts);
+  for (int s = 0; s < nb_lines; s++)
+    for (int n = 0; n < nb_lines; n++) {
+      memset(grid, 0, sizeof(grid));
+      memcpy(grid[0], lines[s], sizeof(line));
+      memcpy(grid[DIMENSION - 1], lines[n], sizeof(line));
+      add_root((uint32_t)grid_index(grid, SOUTH_P));
+    }
+}
+
+static void solve(int nb_threads) {
+  worker *workers = calloc(nb_threads, sizeof(worker));
+  succ = calloc(nb_positions, sizeof(uint32_t *));
+  nb_succ = calloc(nb_positions, sizeof(uint16_t));
+  find_roots();
+
+  double start = now_s();
+  uint32_t *current = malloc(nb_roots * sizeof(uint32_t));
+  memcpy(current, roots, nb_roots * sizeof(uint32_t));
+  size_t count = nb_roots, reached = 0;
+  unsigned long turns = 0;
+  int depth = 0, bad = 0;
+  while (count) {
+    reached += count;
+    level = current;
+    level_size = count;
+    level_pos = 0;
+    for (int i = 0; i < nb_threads; i++)
+      pthread_create(&workers[i].thread, NULL, expand, &workers[i]);
+    count = 0;
+    for (int i = 0; i < nb_threads; i++) {
+      pthread_join(workers[i].thread, NULL);
+      count += workers[i].nb_next;
+    }
+    free(current);
+    current = malloc((count ? count : 1) * sizeof(uint32_t));
+    count = 0;
+    for (int i = 0; i < nb_threads; i++) {
+      memcpy(current + count, workers[i].next, workers[i].nb_next * sizeof(uint32_t));
+      count += workers[i].nb_next;
+      workers[i].nb_next = 0;
+    }
+    depth++;
+  }
+  free(current);
+  for (int i = 0; i < nb_threads; i++) {
+    turns += workers[i].turns;
+    bad += workers[i].bad;
+    free(workers[i].next);
+    free(workers[i].buf);
+  }
+  printf("Parcours : %zu positions atteintes en %d niveaux, %lu tours joués, %.1f s.\n", reached, depth, turns,
+         now_s() - start);
+  if (bad)
+    printf("%s%d tours mènent à une position sans index (pièces perdues ?)%s\n", BGRED, bad, RESET);
+
+  start = now_s();
+  int pass;
+  for (pass = 2;; pass++) {
+    if (pass > TB_MAX_DIST) {
+      printf("%sDistances au-delà de %d : positions restantes comptées nulles.%s\n", BGRED, TB_MAX_DIST, RESET);
+      break;
+    }
+    unsigned long resolved = 0;
+    for (int i = 0; i < nb_threads; i++) {
+      workers[i].lo = (uint32_t)((uint64_t)nb_positions * i / nb_threads);
+      workers[i].hi = (uint32_t)((uint64_t)nb_positions * (i + 1) / nb_threads);
+      workers[i].pass = pass;
+      pthread_create(&workers[i].thread, NULL, solve_slice, &workers[i]);
+    }
+    for (int i = 0; i < nb_threads; i++) {
+      pthread_join(workers[i].thread, NULL);
+      resolved += workers[i].resolved;
+    }
+    if (resolved == 0)
+      break;
+  }
+  printf("Analyse rétrograde : %d passes, %.1f s.\n", pass - 1, now_s() - start);
+  /* les listes de successeurs restent allouées jusqu'à la fin du programme */
+  free(workers);
+}
+
+static void summary(void) {
+  unsigned long by[4][TB_MAX_DIST + 1] = {{0}};
+  unsigned long blocked = 0;
+  for (uint32_t i = 0; i < nb_positions; i++) {
+    by[TB_RESULT(table[i])][TB_DIST(table[i])]++;
+    if (TB_RESULT(table[i]) == TB_DRAW && nb_succ && nb_succ[i] == 0)
+      blocked++;
+  }
+  printf("\n%-14s %12s\n", "résultat", "positions");
+  for (int n = 1; n <= TB_MAX_DIST; n++) {
+    if (by[TB_WIN][n])
+      printf("%sgain en %-6d%s %12lu\n", GREEN, n, RESET, by[TB_WIN][n]);
+    if (by[TB_LOSS][n])
+      printf("%sperte en %-5d%s %12lu\n", RED, n, RESET, by[TB_LOSS][n]);
+  }
+  printf("%snulle%s          %12lu", BLUE, RESET, by[TB_DRAW][0]);
+  if (blocked)
+    printf(" (dont %lu sans tour possible)", blocked);
+  printf("\n\n");
+}
+
+/* --- FICHIER --- */
+
+static void put_u32(FILE *f, uint32_t v) {
+  unsigned char b[4] = {v, v >> 8, v >> 16, v >> 24};
+  fwrite(b, 1, 4, f);
+}
+
+static int get_u32(FILE *f, uint32_t *v) {
+  unsigned char b[4];
+  if (fread(b, 1, 4, f) != 4)
+    return -1;
+  *v = b[0] | b[1] << 8 | b[2] << 16 | (uint32_t)b[3] << 24;
+  return 0;
+}
+
+static int save_table(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+  fwrite("GTBL", 1, 4, f);
+  put_u32(f, 1);
+  put_u32(f, DIMENSION);
+  put_u32(f, nb_positions);
+  fwrite(table, 1, nb_positions, f);
+  for (uint32_t i = 0; i < nb_positions; i++)
+    put_u32(f, parent[i]);
+  return fclose(f) == 0 ? 0 : -1;
+}
+
+static int load_table(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+  char magic[4];
+  uint32_t version, dimension, count;
+  int ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, "GTBL", 4) == 0 && get_u32(f, &version) == 0 && version == 1 &&
+           get_u32(f, &dimension) == 0 && dimension == DIMENSION && get_u32(f, &count) == 0 && count == nb_positions &&
+           fread(table, 1, nb_positions, f) == nb_positions;
+  for (uint32_t i = 0; ok && i < nb_positions; i++)
+    ok = get_u32(f, &parent[i]) == 0 && (parent[i] == NO_INDEX || parent[i] < nb_positions);
+  fclose(f);
+  if (!ok) {
+    fprintf(stderr, "%s: table illisible ou d'une autre DIMENSION\n", path);
+    return -1;
+  }
+  for (uint32_t i = 0; i < nb_positions; i++)
+    if (parent[i] == i) {
+      parent[i] = NO_INDEX;
+      add_root(i);
+    }
+  return 0;
+}
+
+/* --- VÉRIFICATION D'UN MOTEUR --- */
+
+typedef struct shared_s {
+  long positions, errors;
+  int64_t current;
+} shared;
+
+static engine referee, student;
+static shared *res;
+static int max_reports = 20;
+
+static void describe(uint32_t index, char *out, size_t len) {
+  uint8_t e = table[index];
+  switch (TB_RESULT(e)) {
+  case TB_WIN:
+    snprintf(out, len, "gain en %d", TB_DIST(e));
+    break;
+  case TB_LOSS:
+    snprintf(out, len, "perte en %d", TB_DIST(e));
+    break;
+  default:
+    snprintf(out, len, "nulle");
+  }
+}
+
+static void print_grid(uint32_t index) {
+  size grid[DIMENSION][DIMENSION];
+  index_grid(index, grid);
+  for (int l = DIMENSION - 1; l >= 0; l--) {
+    printf("      ");
+    for (int c = 0; c < DIMENSION; c++)
+      printf("%c", grid[l][c] == NONE ? '.' : '0' + grid[l][c]);
+    printf("\n");
+  }
+}
+
+static void report(uint32_t index, int depth, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+static void report(uint32_t index, int depth, const char *fmt, ...) {
+  if (res->errors++ >= max_reports)
+    return;
+  char value[32];
+  describe(index, value, sizeof(value));
+  printf("%s ❌ position %u (%s au trait, %d tours après placement, %s) : ", RED, index,
+         index & 1 ? "NORTH_P" : "SOUTH_P", depth, value);
+  va_list ap;
+  va_start(ap, fmt);
+  vprintf(fmt, ap);
+  va_end(ap);
+  printf("%s\n", RESET);
+  print_grid(index);
+  fflush(stdout);
+}
+
+typedef struct check_s {
+  uint32_t index;
+  player mover;
+  int wins, wrong;
+  /* tours de référence vers les enfants dans l'arbre du parcours */
+  turn *children;
+  uint32_t *child_index;
+  int nb_children, cap_children;
+} check;
+
+static int count_wins(board after, const turn *t, void *ctx) {
+  (void)t;
+  check *k = ctx;
+  player winner = get_winner(after);
+  if (winner == k->mover)
+    k->wins++;
+  else if (winner != NO_PLAYER)
+    k->wrong++;
+  return 0;
+}
+
+static int collect_children(board after, const turn *t, void *ctx) {
+  check *k = ctx;
+  if (get_winner(after) != NO_PLAYER) {
+    k->wins++;
+    return 0;
+  }
+  int64_t idx = board_index(after, next_player(k->mover));
+  if (idx < 0 || parent[idx] != k->index)
+    return 0;
+  for (int i = 0; i < k->nb_children; i++)
+    if (k->child_index[i] == (uint32_t)idx)
+      return 0;
+  if (k->nb_children == k->cap_children) {
+    k->cap_children = k->cap_children ? 2 * k->cap_children : 16;
+    k->children = realloc(k->children, k->cap_children * sizeof(turn));
+    k->child_index = realloc(k->child_index, k->cap_children * sizeof(uint32_t));
+  }
+  k->children[k->nb_children] = *t;
+  k->child_index[k->nb_children++] = (uint32_t)idx;
+  return 0;
+}
+
+/* Tours de référence depuis index ; retourne le nombre de tours gagnants */
+static int reference_turns(uint32_t index, check *k) {
+  engine_use(&referee);
+  board r = index_board(index, &k->mover);
+  k->index = index;
+  k->wins = 0;
+  k->nb_children = 0;
+  gen_turns(r, k->mover, collect_children, k);
+  destroy_game(r);
+  return k->wins;
+}
+
+/* g : la position index chez le moteur vérifié */
+static void check_position(board g, uint32_t index, int depth, int recurse) {
+  res->current = index;
+  res->positions++;
+  size want[DIMENSION][DIMENSION];
+  player mover = index_grid(index, want);
+
+  engine_use(&student);
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++)
+      if (get_piece_size(g, l, c) != want[l][c]) {
+        report(index, depth, "get_piece_size(%d, %d) = %d, la référence a %d", l, c, get_piece_size(g, l, c),
+               want[l][c]);
+        return;
+      }
+  player winner = get_winner(g);
+  if (winner != NO_PLAYER) {
+    report(index, depth, "get_winner = %d sans pièce arrivée au but", winner);
+    return;
+  }
+  check mine = {.mover = mover};
+  gen_turns(g, mover, count_wins, &mine);
+
+  check ref = {0};
+  int ref_wins = reference_turns(index, &ref);
+  if (mine.wins != ref_wins)
+    report(index, depth, "%d tours gagnants d'après get_winner, la référence en trouve %d", mine.wins, ref_wins);
+  if (mine.wrong)
+    report(index, depth, "%d tours désignent l'adversaire comme vainqueur", mine.wrong);
+
+  for (int i = 0; recurse && i < ref.nb_children; i++) {
+    engine_use(&student);
+    board next = copy_game(g);
+    return_code rc = play_turn(next, &ref.children[i]);
+    if (rc != OK) {
+      report(index, depth, "tour de référence refusé (code %d) vers la position %u", rc, ref.child_index[i]);
+    } else {
+      check_position(next, ref.child_index[i], depth + 1, 1);
+    }
+    engine_use(&student);
+    destroy_game(next);
+  }
+  free(ref.children);
+  free(ref.child_index);
+}
+
+/* Placement de la position r chez le moteur vérifié */
+static board student_setup(uint32_t r) {
+  size south[DIMENSION], north[DIMENSION];
+  root_grid(r, south, north);
+  engine_use(&student);
+  board g = new_game();
+  for (int c = 0; c < DIMENSION; c++) {
+    if (south[c] != NONE)
+      place_piece(g, south[c], SOUTH_P, c);
+    if (north[c] != NONE)
+      place_piece(g, north[c], NORTH_P, c);
+  }
+  return g;
+}
+
+/* Tâche : une position après placement (sans descendre), ou un de ses enfants
+   et tout son sous-arbre */
+typedef struct task_s {
+  uint32_t root, index;
+} task;
+
+static void run_task(const task *t) {
+  board g = student_setup(t->root);
+  if (t->index == t->root) {
+    check_position(g, t->root, 0, 0);
+  } else {
+    check ref = {0};
+    reference_turns(t->root, &ref);
+    for (int i = 0; i < ref.nb_children; i++)
+      if (ref.child_index[i] == t->index) {
+        engine_use(&student);
+        board next = copy_game(g);
+        return_code rc = play_turn(next, &ref.children[i]);
+        if (rc != OK)
+          report(t->root, 0, "tour de référence refusé (code %d) vers la position %u", rc, t->index);
+        else
+          check_position(next, t->index, 1, 1);
+        engine_use(&student);
+        destroy_game(next);
+      }
+    free(ref.children);
+    free(ref.child_index);
+  }
+  engine_use(&student);
+  destroy_game(g);
+}
+
+static int verify(const char *path, int nb_workers, int timeout) {
+  if (engine_load(&student, path) < 0)
+    return 0;
+  printf("%s=== VÉRIFICATION : %s ===%s\n\n", BGBLUE, path, RESET);
+  fflush(stdout);
+
+  task *tasks = NULL;
+  size_t nb_tasks = 0;
+  for (int r = 0; r < nb_roots; r++) {
+    tasks = realloc(tasks, (nb_tasks + 1) * sizeof(task));
+    tasks[nb_tasks++] = (task){roots[r], roots[r]};
+  }
+  for (uint32_t i = 0; i < nb_positions; i++)
+    if (parent[i] != NO_INDEX && parent[i] != i && parent[parent[i]] == parent[i]) {
+      tasks = realloc(tasks, (nb_tasks + 1) * sizeof(task));
+      tasks[nb_tasks++] = (task){parent[i], i};
+    }
+
+  shared *all = mmap(NULL, nb_workers * sizeof(shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (all == MAP_FAILED) {
+    perror("mmap");
+    exit(2);
+  }
+  pid_t *pids = calloc(nb_workers, sizeof(pid_t));
+  double start = now_s();
+  for (int w = 0; w < nb_workers; w++) {
+    all[w].current = -1;
+    pids[w] = fork();
+    if (pids[w] < 0) {
+      perror("fork");
+      exit(2);
+    }
+    if (pids[w] == 0) {
+      alarm(timeout);
+      res = &all[w];
+      for (size_t t = w; t < nb_tasks; t += nb_workers)
+        run_task(&tasks[t]);
+      _exit(0);
+    }
+  }
+
+  int ok = 1;
+  long positions = 0, errors = 0;
+  for (int w = 0; w < nb_workers; w++) {
+    int status;
+    waitpid(pids[w], &status, 0);
+    if (WIFSIGNALED(status)) {
+      ok = 0;
+      printf("%s ❌ CRASH: signal %d (%s)", RED, WTERMSIG(status),
+             WTERMSIG(status) == SIGALRM ? "timeout" : strsignal(WTERMSIG(status)));
+      if (all[w].current >= 0)
+        printf(" en position %ld", (long)all[w].current);
+      printf("%s\n", RESET);
+      if (all[w].current >= 0)
+        print_grid((uint32_t)all[w].current);
+    }
+    positions += all[w].positions;
+    errors += all[w].errors;
+  }
+  if (errors)
+    ok = 0;
+  printf("\n%s%ld positions vérifiées en %.1f s, %ld erreurs.%s\n", bgyellow, positions, now_s() - start, errors,
+         RESET);
+  if (ok)
+    printf("%s 🎉 DÉTECTION DU VAINQUEUR CONFORME %s\n\n", GREEN, RESET);
+  else
+    printf("%s ❌ DÉTECTION DU VAINQUEUR NON CONFORME %s\n\n", RED, RESET);
+
+  munmap(all, nb_workers * sizeof(shared));
+  free(pids);
+  free(tasks);
+  engine_unload(&student);
+  return ok;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-r reference.so] [-a] [-c] [-j threads] [-i|-o table] [-t timeout_s] [-m max_reports] "
+          "[engine.so...]\n",
+          prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  const char *referee_path = "reference/board.so", *in = NULL, *out = NULL;
+  int nb_threads = (int)sysconf(_SC_NPROCESSORS_ONLN), timeout = 600;
+  int check_only = 0;
+  int i;
+  for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+    if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+      referee_path = argv[++i];
+    else if (strcmp(argv[i], "-a") == 0)
+      all_setups = 1;
+    else if (strcmp(argv[i], "-c") == 0)
+      check_only = 1;
+    else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      nb_threads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+      in = argv[++i];
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      out = argv[++i];
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      timeout = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+      max_reports = atoi(argv[++i]);
+    else
+      usage(argv[0]);
+  }
+  if (nb_threads < 1)
+    nb_threads = 1;
+
+  if (engine_load(&referee, referee_path) < 0)
+    return 2;
+  *(void **)&position_game = dlsym(referee.handle, "position_game");
+  if (position_game == NULL) {
+    fprintf(stderr, "%s: position_game absente (voir reference/board.c)\n", referee_path);
+    return 2;
+  }
+  engine_use(&referee);
+
+  /* Contrôle des moteurs avant le calcul de la table */
+  int loaded = 1;
+  for (int k = i; k < argc; k++) {
+    if (engine_load(&student, argv[k]) < 0) {
+      loaded = 0;
+      continue;
+    }
+    engine_unload(&student);
+  }
+  if (!loaded)
+    return 2;
+  if (check_only)
+    return 0;
+
+  init_index();
+  table = calloc(nb_positions, 1);
+  parent = malloc(nb_positions * sizeof(uint32_t));
+  if (table == NULL || parent == NULL) {
+    fprintf(stderr, "mémoire insuffisante pour %u positions\n", nb_positions);
+    return 2;
+  }
+  memset(parent, 0xff, nb_positions * sizeof(uint32_t));
+
+  printf("%s=== TABLE DE FINALES, DIMENSION %d : %u positions indexées ===%s\n\n", BGBLUE, DIMENSION, nb_positions,
+         RESET);
+  fflush(stdout);
+  if (in) {
+    if (load_table(in) < 0)
+      return 2;
+    printf("Table lue dans %s.\n", in);
+  } else {
+    solve(nb_threads);
+  }
+  summary();
+  if (out && save_table(out) < 0)
+    return 2;
+  fflush(stdout);
+
+  int ok = 1;
+  for (; i < argc; i++)
+    ok &= verify(argv[i], nb_threads, timeout);
+  engine_unload(&referee);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,440 @@
+#define _DEFAULT_SOURCE
+#include "engine.h"
+#include "search.h"
+#include "turns.h"
+#include <signal.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define GREEN "\033[92m"
+#define BLUE "\033[94m"
+#define bgyellow "\033[103m"
+#define BGRED "\033[101m"
+#define BGBLUE "\033[48;2;100;100;200m"
+#define RESET "\033[0m"
+
+/*
+ * Tournoi toutes-rondes entre moteurs, arbitré par le moteur de référence.
+ *
+ * Chaque moteur est un board.c compilé en .so (voir engine.h). Chaque partie
+ * est jouée dans son propre processus, plusieurs à la fois. Le joueur au
+ * trait choisit son tour avec la recherche alpha-bêta (search.h) sur son
+ * propre moteur ; le tour est joué chez l'arbitre puis chez les deux moteurs,
+ * et les plateaux sont comparés après chaque tour. Tout désaccord avec
+ * l'arbitre est signalé comme bogue de règle et fait perdre la partie au
+ * moteur fautif, de même qu'un plantage ou un dépassement de temps.
+ *   ./tournament [-r arbitre.so] [-g parties] [-j processus] [-d profondeur]
+ *                [-p demi-coups] [-t timeout_s] [-m max_rapports] moteur.so...
+ */
+
+#define MAX_ENGINES 64
+#define REPORT_LEN 200
+#define MAX_GAME_MEMORY (1024L * 1024 * 1024)
+
+enum { GAME_PENDING, GAME_DONE };
+
+/* Résultat d'une partie, écrit par le processus qui la joue */
+typedef struct game_s {
+  int south, north;  /* indices des moteurs */
+  int setup;         /* graine du placement */
+  int status;
+  player winner;     /* côté gagnant, NO_PLAYER pour une nulle */
+  int plies;
+  player blame;      /* côté en cours d'appel : NO_PLAYER pour l'arbitre */
+} game;
+
+typedef struct report_s {
+  int game, engine, ply;
+  char text[REPORT_LEN];
+} report;
+
+typedef struct shared_s {
+  atomic_int nb_reports;
+  int max_reports;
+  report reports[];
+} shared;
+
+static engine referee;
+static engine engines[MAX_ENGINES];
+static int nb_engines = 0;
+static shared *out = NULL;
+
+static const char *engine_name(int i) {
+  return i < 0 ? "arbitre" : engines[i].path;
+}
+
+static void add_report(int g, int e, int ply, const char *fmt, ...) {
+  int n = atomic_fetch_add(&out->nb_reports, 1);
+  if (n >= out->max_reports)
+    return;
+  report *r = &out->reports[n];
+  r->game = g;
+  r->engine = e;
+  r->ply = ply;
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(r->text, REPORT_LEN, fmt, ap);
+  va_end(ap);
+}
+
+/* Sans passer par next_player : le moteur choisi peut se tromper */
+static player opponent(player p) {
+  return p == SOUTH_P ? NORTH_P : SOUTH_P;
+}
+
+/* --- PLACEMENT --- */
+
+/* Ligne de départ tirée de la graine : permutation des tailles initiales */
+static void setup_line(uint64_t *seed, size line[DIMENSION]) {
+  for (int c = 0; c < DIMENSION; c++)
+    line[c] = standard_piece(c);
+  for (int c = DIMENSION - 1; c > 0; c--) {
+    *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int k = (*seed >> 33) % (c + 1);
+    size tmp = line[c];
+    line[c] = line[k];
+    line[k] = tmp;
+  }
+}
+
+/* --- PARTIE --- */
+
+typedef struct side_s {
+  int index;       /* indice du moteur */
+  const engine *e;
+  board b;         /* la partie telle que ce moteur la voit */
+} side;
+
+static const char *step_text(const step *s, char *buf, size_t len) {
+  if (s->call == CALL_PICK)
+    snprintf(buf, len, "pick_piece(%d,%d,%d)", s->a, s->b, s->c);
+  else if (s->call == CALL_MOVE)
+    snprintf(buf, len, "move_piece(%d)", s->a);
+  else
+    snprintf(buf, len, "%s(%d,%d)", call_name(s->call), s->a, s->b);
+  return buf;
+}
+
+/* Compare le plateau d'un moteur à celui de l'arbitre, retourne 0 si différent */
+static int same_board(int g, int ply, side *s, board ref) {
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++) {
+      size want = referee.get_piece_size(ref, l, c);
+      size got = s->e->get_piece_size(s->b, l, c);
+      if (got != want) {
+        add_report(g, s->index, ply, "get_piece_size(%d,%d) : %d, arbitre %d", l, c, got, want);
+        return 0;
+      }
+    }
+  player want = referee.get_winner(ref), got = s->e->get_winner(s->b);
+  if (got != want) {
+    add_report(g, s->index, ply, "get_winner : %d, arbitre %d", got, want);
+    return 0;
+  }
+  return 1;
+}
+
+static int count_turn(board after, const turn *t, void *ctx) {
+  (void)after;
+  (void)t;
+  (void)ctx;
+  return -1;
+}
+
+/* Joue une partie ; le vainqueur est un côté, NO_PLAYER pour une nulle */
+static void play_game(int g, game *gm, int depth, int max_plies) {
+  side sides[NB_PLAYERS + 1];
+  sides[SOUTH_P] = (side){gm->south, &engines[gm->south], NULL};
+  sides[NORTH_P] = (side){gm->north, &engines[gm->north], NULL};
+  search_options opt = {0, depth, 1};
+
+  gm->blame = NO_PLAYER;
+  board ref = referee.new_game();
+  for (int p = SOUTH_P; p <= NORTH_P; p++) {
+    gm->blame = p;
+    engine_use(sides[p].e);
+    sides[p].b = new_game();
+  }
+
+  /* placement */
+  uint64_t seed = 0x853c49e6748fea9bULL ^ (uint64_t)gm->setup * 0x9e3779b97f4a7c15ULL;
+  size lines[NB_PLAYERS + 1][DIMENSION];
+  setup_line(&seed, lines[SOUTH_P]);
+  setup_line(&seed, lines[NORTH_P]);
+  for (int c = 0; c < DIMENSION; c++)
+    for (player p = SOUTH_P; p <= NORTH_P; p++) {
+      if (lines[p][c] == NONE)
+        continue;
+      gm->blame = NO_PLAYER;
+      return_code want = referee.place_piece(ref, lines[p][c], p, c);
+      for (int q = SOUTH_P; q <= NORTH_P; q++) {
+        gm->blame = q;
+        return_code got = sides[q].e->place_piece(sides[q].b, lines[p][c], p, c);
+        if (got != want) {
+          add_report(g, sides[q].index, 0, "place_piece(%d,%d,%d) : %d, arbitre %d", lines[p][c], p, c, got, want);
+          gm->winner = opponent(q);
+          return;
+        }
+      }
+    }
+  for (int q = SOUTH_P; q <= NORTH_P; q++) {
+    gm->blame = q;
+    if (!same_board(g, 0, &sides[q], ref)) {
+      gm->winner = opponent(q);
+      return;
+    }
+  }
+
+  /* tours */
+  player p = SOUTH_P;
+  for (gm->plies = 1; gm->plies <= max_plies; gm->plies++) {
+    side *s = &sides[p];
+    gm->blame = p;
+    engine_use(s->e);
+    search_clear();
+    search_result r = search_best_turn(s->b, p, &opt);
+
+    gm->blame = NO_PLAYER;
+    engine_use(&referee);
+    if (!r.has_move) {
+      int n = gen_turns(ref, p, count_turn, NULL);
+      if (n != 0) {
+        add_report(g, s->index, gm->plies, "aucun tour trouvé, l'arbitre en trouve");
+        gm->winner = opponent(p);
+      } else {
+        gm->winner = NO_PLAYER; /* partie bloquée */
+      }
+      return;
+    }
+    for (int i = 0; i < r.best.nb_steps; i++) {
+      int got = step_exec(ref, &r.best.steps[i], NULL);
+      if (got != OK) {
+        char buf[64];
+        add_report(g, s->index, gm->plies, "tour illégal : %s refusé par l'arbitre (%d)",
+                   step_text(&r.best.steps[i], buf, sizeof(buf)), got);
+        gm->winner = opponent(p);
+        return;
+      }
+    }
+
+    for (int q = SOUTH_P; q <= NORTH_P; q++) {
+      gm->blame = q;
+      engine_use(sides[q].e);
+      for (int i = 0; i < r.best.nb_steps; i++) {
+        int got = step_exec(sides[q].b, &r.best.steps[i], NULL);
+        if (got != OK) {
+          char buf[64];
+          add_report(g, sides[q].index, gm->plies, "tour légal refusé : %s retourne %d",
+                     step_text(&r.best.steps[i], buf, sizeof(buf)), got);
+          gm->winner = opponent(q);
+          return;
+        }
+      }
+      if (!same_board(g, gm->plies, &sides[q], ref)) {
+        gm->winner = opponent(q);
+        return;
+      }
+    }
+
+    gm->blame = NO_PLAYER;
+    player w = referee.get_winner(ref);
+    if (w != NO_PLAYER) {
+      gm->winner = w;
+      return;
+    }
+    p = opponent(p);
+  }
+  gm->plies = max_plies;
+  gm->winner = NO_PLAYER;
+}
+
+/* --- RÉPARTITION --- */
+
+static double now_s(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* Partie jouée dans un processus fils : un moteur peut planter ou boucler */
+static pid_t start_game(int g, game *gm, int depth, int max_plies, int timeout) {
+  pid_t pid = fork();
+  if (pid == 0) {
+    /* un moteur qui laisse revenir en arrière fait exploser la génération des tours */
+    struct rlimit mem = {MAX_GAME_MEMORY, MAX_GAME_MEMORY};
+    setrlimit(RLIMIT_AS, &mem);
+    alarm(timeout);
+    search_init(1);
+    play_game(g, gm, depth, max_plies);
+    gm->status = GAME_DONE;
+    _exit(0);
+  }
+  return pid;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-r referee.so] [-g games_per_pairing] [-j workers] [-d depth] [-p max_plies]"
+          " [-t timeout_s] [-m max_reports] engine.so...\n",
+          prog);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  const char *referee_path = "reference/board.so";
+  int nb_workers = (int)sysconf(_SC_NPROCESSORS_ONLN), per_pairing = 2, depth = 1, max_plies = 200;
+  int timeout = 20, max_reports = 20;
+  const char *paths[MAX_ENGINES];
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+      referee_path = argv[++i];
+    else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+      per_pairing = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      nb_workers = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+      depth = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+      max_plies = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      timeout = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+      max_reports = atoi(argv[++i]);
+    else if (argv[i][0] != '-' && nb_engines < MAX_ENGINES)
+      paths[nb_engines++] = argv[i];
+    else
+      usage(argv[0]);
+  }
+  if (nb_engines == 0 || per_pairing < 1)
+    usage(argv[0]);
+  if (nb_workers < 1)
+    nb_workers = 1;
+
+  if (engine_load(&referee, referee_path) < 0)
+    return 2;
+  for (int i = 0; i < nb_engines; i++)
+    if (engine_load(&engines[i], paths[i]) < 0)
+      return 2;
+
+  /* Chaque paire joue per_pairing parties, chaque placement avec les deux couleurs ;
+     un moteur seul joue contre lui-même */
+  int nb_pairs = nb_engines == 1 ? 1 : nb_engines * (nb_engines - 1) / 2;
+  int nb_games = nb_pairs * per_pairing;
+  game *games = mmap(NULL, nb_games * sizeof(game), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  out = mmap(NULL, sizeof(shared) + max_reports * sizeof(report), PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (games == MAP_FAILED || out == MAP_FAILED) {
+    perror("mmap");
+    return 2;
+  }
+  out->max_reports = max_reports;
+  int g = 0;
+  for (int i = 0; i < nb_engines; i++)
+    for (int j = nb_engines == 1 ? i : i + 1; j < nb_engines; j++)
+      for (int k = 0; k < per_pairing; k++, g++) {
+        games[g].south = k % 2 ? j : i;
+        games[g].north = k % 2 ? i : j;
+        games[g].setup = g / 2;
+        games[g].winner = NO_PLAYER;
+        games[g].blame = NO_PLAYER;
+      }
+
+  printf("%s=== TOURNOI : %d moteurs, %d parties, %d processus, profondeur %d ===%s\n\n", BGBLUE,
+         nb_engines, nb_games, nb_workers, depth, RESET);
+  fflush(stdout);
+
+  pid_t *pids = calloc(nb_games, sizeof(pid_t));
+  int next = 0, running = 0, crashes = 0;
+  double start = now_s();
+  while (next < nb_games || running > 0) {
+    while (next < nb_games && running < nb_workers) {
+      pids[next] = start_game(next, &games[next], depth, max_plies, timeout);
+      if (pids[next] < 0) {
+        perror("fork");
+        return 2;
+      }
+      next++;
+      running++;
+    }
+    int status;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0)
+      break;
+    running--;
+    int i = 0;
+    while (i < next && pids[i] != pid)
+      i++;
+    game *gm = &games[i];
+    if (gm->status == GAME_DONE && WIFEXITED(status))
+      continue;
+    /* plantage, dépassement de temps ou sortie prématurée : le moteur en cours d'appel perd */
+    crashes++;
+    int e = gm->blame == SOUTH_P ? gm->south : gm->blame == NORTH_P ? gm->north : -1;
+    if (WIFSIGNALED(status))
+      add_report(i, e, gm->plies, "signal %d (%s)", WTERMSIG(status),
+                 WTERMSIG(status) == SIGALRM ? "timeout" : strsignal(WTERMSIG(status)));
+    else
+      add_report(i, e, gm->plies, "sortie prématurée (code %d)", WEXITSTATUS(status));
+    gm->winner = gm->blame == NO_PLAYER ? NO_PLAYER : opponent(gm->blame);
+    gm->status = GAME_DONE;
+  }
+  double elapsed = now_s() - start;
+
+  /* classement */
+  int wins[MAX_ENGINES] = {0}, draws[MAX_ENGINES] = {0}, losses[MAX_ENGINES] = {0}, bugs[MAX_ENGINES] = {0};
+  long plies = 0;
+  for (int i = 0; i < nb_games; i++) {
+    game *gm = &games[i];
+    plies += gm->plies;
+    if (gm->winner == NO_PLAYER) {
+      draws[gm->south]++;
+      draws[gm->north]++;
+    } else {
+      wins[gm->winner == SOUTH_P ? gm->south : gm->north]++;
+      losses[gm->winner == SOUTH_P ? gm->north : gm->south]++;
+    }
+  }
+  int nb_reports = atomic_load(&out->nb_reports);
+  for (int i = 0; i < nb_reports && i < max_reports; i++)
+    if (out->reports[i].engine >= 0)
+      bugs[out->reports[i].engine]++;
+
+  printf("%-40s %7s %5s %5s %5s %8s\n", "moteur", "points", "V", "N", "D", "bogues");
+  for (int i = 0; i < nb_engines; i++)
+    printf("%s%-40s %7.1f %5d %5d %5d %8d%s\n", bugs[i] ? RED : GREEN, engine_name(i),
+           wins[i] + draws[i] / 2.0, wins[i], draws[i], losses[i], bugs[i], RESET);
+  printf("\n");
+
+  for (int i = 0; i < nb_reports && i < max_reports; i++) {
+    report *r = &out->reports[i];
+    game *gm = &games[r->game];
+    printf("%s ❌ partie %d (%s contre %s), demi-coup %d%s\n", RED, r->game, engine_name(gm->south),
+           engine_name(gm->north), r->ply, RESET);
+    printf("%s    %s : %s%s\n\n", RED, engine_name(r->engine), r->text, RESET);
+  }
+  if (nb_reports > max_reports)
+    printf("%s... %d rapports non affichés.%s\n\n", RED, nb_reports - max_reports, RESET);
+
+  printf("%s%d parties (%ld demi-coups) en %.2f s : %.1f parties/s, %d plantages.%s\n", bgyellow, nb_games,
+         plies, elapsed, elapsed > 0 ? nb_games / elapsed : 0, crashes, RESET);
+  if (nb_reports == 0)
+    printf("%s 🎉 AUCUN DÉSACCORD AVEC L'ARBITRE %s\n", GREEN, RESET);
+  else
+    printf("%s ❌ %d DÉSACCORDS AVEC L'ARBITRE %s\n", RED, nb_reports, RESET);
+
+  free(pids);
+  for (int i = 0; i < nb_engines; i++)
+    engine_unload(&engines[i]);
+  engine_unload(&referee);
+  return nb_reports ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+#define _DEFAULT_SOURCE
+#include "tracer.h"
+#include "record.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RED "\033[91m"
+#define BLUE "\033[94m"
+#define RESET "\033[0m"
+
+/* Anneaux des threads, dans l'ordre de leur premier appel au moteur ; au-delà
+ * de MAX_RINGS threads, les suivants partagent un anneau qui n'est pas affiché */
+#define MAX_RINGS 64
+static trace_ring rings[MAX_RINGS];
+static int nb_rings = 0;
+static __thread trace_ring spare;
+
+__thread trace_ring *trace_local = NULL;
+int trace_clock = 1;
+
+/* appels affichés par anneau (BOARD_TRACE) */
+static int depth = 16;
+/* point de départ pour convertir les cycles en nanosecondes */
+static uint64_t origin_ticks, origin_ns;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+__attribute__((constructor)) static void tracer_init(void) {
+  const char *s = getenv("BOARD_TRACE");
+  if (s != NULL && *s != '\0')
+    depth = atoi(s);
+  if (depth > TRACE_SIZE)
+    depth = TRACE_SIZE;
+  origin_ns = now_ns();
+  origin_ticks = trace_ticks();
+}
+
+trace_ring *trace_register(void) {
+  int i = __atomic_fetch_add(&nb_rings, 1, __ATOMIC_RELAXED);
+  trace_local = i < MAX_RINGS ? &rings[i] : &spare;
+  return trace_local;
+}
+
+void trace_reset(const char *label) {
+  trace_ring *r = trace_local != NULL ? trace_local : trace_register();
+  r->head = 0;
+  r->label = label;
+}
+
+/* --- AFFICHAGE, SANS ALLOCATION NI STDIO --- */
+
+typedef struct out_s {
+  int fd;
+  size_t len;
+  char buf[4096];
+} out;
+
+static void flush(out *o) {
+  size_t done = 0;
+  while (done < o->len) {
+    ssize_t n = write(o->fd, o->buf + done, o->len - done);
+    if (n <= 0)
+      break;
+    done += n;
+  }
+  o->len = 0;
+}
+
+static void put(out *o, const char *s) {
+  for (; *s; s++) {
+    if (o->len == sizeof(o->buf))
+      flush(o);
+    o->buf[o->len++] = *s;
+  }
+}
+
+/* Entier aligné à droite sur width caractères (à gauche si width < 0) */
+static void put_int(out *o, long v, int width) {
+  char tmp[24], *p = tmp + sizeof(tmp);
+  unsigned long u = v < 0 ? -(unsigned long)v : (unsigned long)v;
+  *--p = '\0';
+  do
+    *--p = '0' + u % 10;
+  while ((u /= 10) > 0);
+  if (v < 0)
+    *--p = '-';
+  int len = tmp + sizeof(tmp) - 1 - p;
+  for (int i = len; i < width; i++)
+    put(o, " ");
+  put(o, p);
+  for (int i = len; i < -width; i++)
+    put(o, " ");
+}
+
+static void dump_ring(out *o, const trace_ring *r, int thread, const char *title, uint64_t now, double ns_per_tick) {
+  unsigned long head = r->head;
+  __atomic_signal_fence(__ATOMIC_ACQUIRE);
+  unsigned long first = head > (unsigned long)depth ? head - depth : 0;
+  put(o, BLUE "      ── ");
+  put(o, title);
+  if (r->label != NULL) {
+    put(o, ", ");
+    put(o, r->label);
+  }
+  if (nb_rings > 1) {
+    put(o, ", thread ");
+    put_int(o, thread, 0);
+  }
+  put(o, " : ");
+  put_int(o, head - first, 0);
+  put(o, " derniers appels au moteur sur ");
+  put_int(o, head, 0);
+  put(o, " ──" RESET "\n");
+  for (unsigned long i = first; i < head; i++) {
+    const trace_entry *e = &r->entries[i & (TRACE_SIZE - 1)];
+    /* durée de l'appel, ou depuis son début s'il n'est pas revenu */
+    int running = !e->done;
+    uint64_t end = running ? now : e->end;
+    long ns = end > e->start ? (long)((end - e->start) * ns_per_tick) : 0;
+    put(o, running ? RED : BLUE);
+    put_int(o, i, 12);
+    if (e->game < 0)
+      put(o, "       ");
+    else {
+      put(o, "  g");
+      put_int(o, e->game, -4);
+    }
+    put(o, rec_op_name(e->op));
+    for (int k = 0; k < rec_nb_args(e->op); k++) {
+      put(o, " ");
+      put_int(o, e->args[k], 0);
+    }
+    /* appel non daté (trace_clock à 0) : durée inconnue */
+    int timed = e->start != 0;
+    if (running) {
+      put(o, " -> en cours");
+      if (timed) {
+        put(o, " depuis ");
+        put_int(o, ns, 0);
+        put(o, " ns");
+      }
+      put(o, RESET "\n");
+      continue;
+    }
+    put(o, " -> ");
+    put_int(o, e->result, 0);
+    if (timed) {
+      put(o, "  (");
+      put_int(o, ns, 0);
+      put(o, " ns)");
+    }
+    put(o, RESET "\n");
+  }
+}
+
+void trace_dump(int fd, const char *title) {
+  if (depth <= 0)
+    return;
+  uint64_t now = trace_ticks(), ticks = now - origin_ticks;
+  double ns_per_tick = ticks > 0 ? (double)(now_ns() - origin_ns) / ticks : 1;
+  out o;
+  o.fd = fd;
+  o.len = 0;
+  int n = nb_rings < MAX_RINGS ? nb_rings : MAX_RINGS;
+  for (int i = 0; i < n; i++)
+    dump_ring(&o, &rings[i], i + 1, title, now, ns_per_tick);
+  flush(&o);
+}
@@ -0,0 +1,134 @@
+#ifndef _TRACER_H_
+#define _TRACER_H_
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * \file tracer.h
+ *
+ * \brief Derniers appels faits au moteur, gardés en permanence.
+ *
+ * Chaque thread a son anneau des ::TRACE_SIZE derniers appels à board.h,
+ * rempli par les enveloppes de recorder.c : opération (un ::call ou un
+ * ::rec_op, voir record.h), numéro de partie, arguments tels que le moteur
+ * les reçoit, résultat et instant de l'appel. L'entrée est ouverte avant
+ * l'appel au moteur et fermée au retour : après un plantage ou un blocage,
+ * le dernier appel apparaît « en cours ».
+ *
+ * L'écriture ne prend pas de verrou et ne fait pas d'appel système : le
+ * traceur reste actif pendant la correction. Le compteur de cycles est lu
+ * juste avant et juste après l'appel : la durée affichée est celle du
+ * moteur seul (plus une lecture du compteur, quelques dizaines de ns sous
+ * virtualisation). Un programme qui enchaîne les appels au plus vite (fuzz)
+ * peut arrêter ces lectures par ::trace_clock ; les durées ne sont alors
+ * pas affichées. Les anneaux sont affichés par trace_dump, depuis un test
+ * en échec ou un gestionnaire de signal (plantage, délai dépassé).
+ *
+ * La variable BOARD_TRACE donne le nombre d'appels affichés par anneau
+ * (16 par défaut, 0 pour ne rien afficher).
+ */
+
+/**
+ * @brief nombre d'entrées d'un anneau (puissance de 2).
+ */
+#define TRACE_SIZE 256
+
+/**
+ * @brief un appel au moteur.
+ */
+typedef struct trace_entry_s {
+  uint64_t start;   /**< début, en cycles */
+  uint64_t end;     /**< retour, en cycles */
+  int op;           /**< un ::call ou un ::rec_op */
+  int game;         /**< numéro de la partie, -1 si inconnue */
+  int args[3];      /**< arguments, dans l'ordre de l'API */
+  int result;       /**< résultat */
+  int done;         /**< 0 tant que l'appel n'est pas revenu */
+} trace_entry;
+
+/**
+ * @brief anneau d'un thread.
+ */
+typedef struct trace_ring_s {
+  trace_entry entries[TRACE_SIZE];
+  unsigned long head; /**< appels enregistrés depuis le dernier trace_reset */
+  const char *label;  /**< test en cours, donné à trace_reset */
+} trace_ring;
+
+/**
+ * @brief 1 (par défaut) pour dater les appels, 0 pour ne garder que leur contenu.
+ */
+extern int trace_clock;
+
+/**
+ * @brief anneau du thread courant, NULL avant son premier appel au moteur.
+ */
+extern __thread trace_ring *trace_local;
+
+/**
+ * @brief attribue un anneau au thread courant.
+ *
+ * Les anneaux sont pris dans une réserve statique et jamais rendus : celui
+ * d'un thread terminé reste lisible par trace_dump.
+ */
+trace_ring *trace_register(void);
+
+/**
+ * @brief compteur de temps : cycles du processeur, ou nanosecondes ailleurs qu'en x86.
+ */
+static inline __attribute__((always_inline)) uint64_t trace_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief ouvre une entrée avant l'appel au moteur.
+ */
+static inline __attribute__((always_inline)) trace_entry *trace_begin(int op, int game, int a, int b, int c) {
+  trace_ring *r = trace_local;
+  if (r == NULL)
+    r = trace_register();
+  trace_entry *e = &r->entries[r->head & (TRACE_SIZE - 1)];
+  e->op = op;
+  e->game = game;
+  e->args[0] = a;
+  e->args[1] = b;
+  e->args[2] = c;
+  e->result = 0;
+  e->done = 0;
+  e->start = trace_clock ? trace_ticks() : 0;
+  /* l'entrée est complète avant d'être visible d'un gestionnaire de signal */
+  __atomic_signal_fence(__ATOMIC_RELEASE);
+  r->head++;
+  return e;
+}
+
+/**
+ * @brief ferme l'entrée au retour du moteur.
+ */
+static inline __attribute__((always_inline)) void trace_end(trace_entry *e, int result) {
+  e->end = trace_clock ? trace_ticks() : 0;
+  e->result = result;
+  __atomic_signal_fence(__ATOMIC_RELEASE);
+  e->done = 1;
+}
+
+/**
+ * @brief vide l'anneau du thread courant au début d'un test, nommé dans les affichages.
+ */
+void trace_reset(const char *label);
+
+/**
+ * @brief affiche les derniers appels de chaque thread sur fd, sous un titre.
+ *
+ * Utilisable depuis un gestionnaire de signal : seul write(2) est appelé.
+ */
+void trace_dump(int fd, const char *title);
+
+#endif /*_TRACER_H_*/
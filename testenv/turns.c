@@ -0,0 +1,124 @@
+#include "turns.h"
+#include <string.h>
+
+typedef struct walk_s {
+  turn_callback cb;
+  void *ctx;
+  int found;
+  int stop;
+} walk;
+
+/* Rend une position terminée au rappel, qui peut la garder */
+static void emit(walk *w, board after, const turn *t) {
+  w->found++;
+  int keep = w->cb(after, t, w->ctx);
+  if (keep < 0)
+    w->stop = 1;
+  if (keep != 1)
+    destroy_game(after);
+}
+
+static void push(turn *t, int call, int a, int b) {
+  step *s = &t->steps[t->nb_steps++];
+  s->call = call;
+  s->a = a;
+  s->b = b;
+  s->c = 0;
+  s->expected = OK;
+  s->line = 0;
+}
+
+/* Poursuit le mouvement de la pièce en main dans toutes les directions */
+static void walk_piece(walk *w, board g, turn *t) {
+  if (t->nb_steps >= MAX_TURN_STEPS - 1 || w->stop)
+    return;
+
+  /* Arrivée sur une pièce : le remplacement est possible vers toute case vide */
+  if (movement_left(g) == 0) {
+    int pl = picked_piece_line(g), pc = picked_piece_column(g);
+    for (int l = 0; l < DIMENSION && !w->stop; l++)
+      for (int c = 0; c < DIMENSION && !w->stop; c++) {
+        if ((l == pl && c == pc) || get_piece_size(g, l, c) != NONE)
+          continue;
+        board next = copy_game(g);
+        if (swap_piece(next, l, c) == OK) {
+          push(t, CALL_SWAP, l, c);
+          emit(w, next, t);
+          t->nb_steps--;
+        } else {
+          destroy_game(next);
+        }
+      }
+  }
+
+  for (direction d = GOAL; d <= WEST && !w->stop; d++) {
+    board next = copy_game(g);
+    if (move_piece(next, d) != OK) {
+      destroy_game(next);
+      continue;
+    }
+    push(t, CALL_MOVE, d, 0);
+    if (picked_piece_owner(next) == NO_PLAYER) {
+      emit(w, next, t);
+    } else {
+      walk_piece(w, next, t);
+      destroy_game(next);
+    }
+    t->nb_steps--;
+  }
+}
+
+int gen_turns(board game, player current_player, turn_callback cb, void *ctx) {
+  walk w = {cb, ctx, 0, 0};
+  turn t;
+  t.nb_steps = 0;
+  int line = current_player == SOUTH_P ? southmost_occupied_line(game) : northmost_occupied_line(game);
+  if (line < 0 || get_winner(game) != NO_PLAYER)
+    return 0;
+  for (int c = 0; c < DIMENSION && !w.stop; c++) {
+    if (get_piece_size(game, line, c) == NONE)
+      continue;
+    board g = copy_game(game);
+    if (pick_piece(g, current_player, line, c) == OK) {
+      t.steps[0] = (step){CALL_PICK, current_player, line, c, OK, 0};
+      t.nb_steps = 1;
+      walk_piece(&w, g, &t);
+    }
+    destroy_game(g);
+  }
+  return w.stop ? -1 : w.found;
+}
+
+size standard_piece(int column) {
+  return column < NB_SIZE * NB_INITIAL_PIECES ? (size)(ONE + column / NB_INITIAL_PIECES) : NONE;
+}
+
+return_code play_turn(board game, const turn *t) {
+  for (int i = 0; i < t->nb_steps; i++) {
+    int r = step_exec(game, &t->steps[i], NULL);
+    if (r != OK)
+      return r;
+  }
+  return OK;
+}
+
+board_key make_key(board game, player to_move) {
+  board_key k;
+  memset(&k, 0, sizeof(k));
+  int bit = 0;
+  for (int l = 0; l < DIMENSION; l++)
+    for (int c = 0; c < DIMENSION; c++, bit += 2)
+      k.w[bit / 64] |= (uint64_t)(get_piece_size(game, l, c) & 3) << (bit % 64);
+  k.w[bit / 64] |= (uint64_t)(to_move == NORTH_P) << (bit % 64);
+  return k;
+}
+
+uint64_t key_hash(const board_key *k) {
+  uint64_t h = 0x9e3779b97f4a7c15ULL;
+  for (int i = 0; i < KEY_WORDS; i++) {
+    h ^= k->w[i];
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+  }
+  return h;
+}
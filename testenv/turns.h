@@ -0,0 +1,92 @@
+#ifndef _TURNS_H_
+#define _TURNS_H_
+
+#include "board.h"
+#include "scenario.h"
+#include <stdint.h>
+
+/**
+ * \file turns.h
+ *
+ * \brief Génération des tours complets d'un joueur à travers l'API board.h.
+ *
+ * Un tour complet est une suite d'appels (pick_piece, move_piece, rebonds,
+ * éventuellement swap_piece) qui rend la main, ou qui fait gagner le joueur.
+ * Les positions sont explorées par copy_game : le moteur lié est utilisé tel
+ * quel, sans connaissance de sa structure interne.
+ */
+
+/**
+ * @brief nombre maximal d'appels dans un tour (un moteur faux pourrait boucler).
+ */
+#define MAX_TURN_STEPS 64
+
+/**
+ * @brief un tour complet, sous forme d'appels rejouables.
+ */
+typedef struct turn_s {
+  step steps[MAX_TURN_STEPS];
+  int nb_steps;
+} turn;
+
+/**
+ * @brief fonction appelée pour chaque tour trouvé.
+ *
+ * @param after la partie après le tour ; elle appartient à l'appelant de
+ *   gen_turns et est détruite au retour, sauf si le rappel retourne 1
+ *   (il en prend alors possession).
+ * @param t le tour joué.
+ * @return 1 pour garder after, 0 sinon ; -1 pour arrêter la génération.
+ */
+typedef int (*turn_callback)(board after, const turn *t, void *ctx);
+
+/**
+ * @brief énumère tous les tours complets de current_player.
+ * @return le nombre de tours trouvés, ou -1 si le rappel a arrêté la génération.
+ */
+int gen_turns(board game, player current_player, turn_callback cb, void *ctx);
+
+/**
+ * @brief pièce de la colonne column dans le placement standard (1 1 2 2 3 3).
+ *
+ * Au-delà des NB_SIZE * ::NB_INITIAL_PIECES premières colonnes (grands
+ * plateaux), la ligne de départ reste vide : ::NONE.
+ */
+size standard_piece(int column);
+
+/**
+ * @brief rejoue un tour sur une partie.
+ * @return ::OK si chaque appel a retourné ::OK, le premier code d'erreur sinon.
+ */
+return_code play_turn(board game, const turn *t);
+
+/**
+ * @brief nombre de mots de 64 bits d'une clé de plateau.
+ *
+ * Deux bits par case, plus un bit pour le joueur au trait.
+ */
+#define KEY_WORDS ((2 * DIMENSION * DIMENSION + 1 + 63) / 64)
+
+/**
+ * @brief nombre d'octets utiles d'une clé sérialisée.
+ */
+#define KEY_BYTES ((2 * DIMENSION * DIMENSION + 1 + 7) / 8)
+
+/**
+ * @brief clé canonique d'une position entre deux tours.
+ */
+typedef struct board_key_s {
+  uint64_t w[KEY_WORDS];
+} board_key;
+
+/**
+ * @brief lit la position par get_piece_size et construit sa clé.
+ */
+board_key make_key(board game, player to_move);
+
+/**
+ * @brief hachage 64 bits d'une clé.
+ */
+uint64_t key_hash(const board_key *k);
+
+#endif /*_TURNS_H_*/